@@ -0,0 +1,356 @@
+#include "hw03.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Benchmarks for the contact list.
+ *
+ * usage: contact_bench [max contacts] [numbered|people|prefixed]
+ *
+ * Directories of 10^3 contacts up to the given size (default 10^6) are built
+ * from synthetic names:
+ *   numbered  "Contact " and a scrambled number, all about the same length (default)
+ *   people    first and last names drawn with a skew towards common ones, repeated
+ *             combinations get a counter, so many names share long prefixes
+ *   prefixed  a long prefix common to all names followed by a number, which makes
+ *             every comparison and hash walk over many characters
+ *
+ * Contacts get increasing numbers, except for the adds marked "random numbers"
+ * and the mixed load below, whose numbers land all over the number index.
+ *
+ * Every operation is timed on its own, and the mean, the median, the 90th and
+ * 99th percentile and the maximum time per operation are printed, so single slow
+ * operations (rehashes, compactions) show up next to the average. Operations on
+ * the whole list (bulk_add, sort, to_string, ...) run once and only have a mean.
+ * The time it takes to read the clock is measured and subtracted.
+ *
+ * Then threads look up, add and remove
+ * contacts of one directory at the same time, once with a single mutex around
+ * a storage and once with a concurrent_storage, and the time per operation and
+ * thread is printed.
+ *
+ * Configure with -DCMAKE_BUILD_TYPE=Release, debug numbers are meaningless.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Results must go somewhere, otherwise the compiler removes the work
+volatile size_t sink;
+
+/// How the names of the synthetic directories look, see the top of this file
+enum class name_distribution { numbered, people, prefixed };
+
+/// Nanoseconds it takes to read the clock twice, measured once at the start
+double clock_overhead = 0;
+
+double elapsed_ns(clock_type::time_point start, clock_type::time_point stop) {
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/// Measure the median time of reading the clock twice
+double measure_clock_overhead() {
+    std::vector<double> ns(10'000);
+    for (double& n : ns) {
+        auto start = clock_type::now();
+        n = elapsed_ns(start, clock_type::now());
+    }
+    std::nth_element(ns.begin(), ns.begin() + static_cast<std::ptrdiff_t>(ns.size() / 2), ns.end());
+    return ns[ns.size() / 2];
+}
+
+void print_header() {
+    std::cout << std::left << std::setw(24) << "operation" << std::right << std::setw(10) << "contacts";
+    for (const char* column : {"mean ns", "p50 ns", "p90 ns", "p99 ns", "max ns"}) {
+        std::cout << std::setw(13) << column;
+    }
+    std::cout << '\n';
+}
+
+/// Run `f` for each of the `count` operations, timing each one, and print the distribution of the times
+template <typename F>
+void report(const std::string& name, size_t contacts, size_t count, F f) {
+    std::vector<double> ns(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto start = clock_type::now();
+        f(i);
+        ns[i] = std::max(0.0, elapsed_ns(start, clock_type::now()) - clock_overhead);
+    }
+    double mean = 0;
+    for (double n : ns) {
+        mean += n / static_cast<double>(count);
+    }
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << contacts << std::fixed
+              << std::setprecision(0) << std::setw(13) << mean;
+    if (count > 1) {
+        std::sort(ns.begin(), ns.end());
+        for (double quantile : {0.5, 0.9, 0.99}) {
+            std::cout << std::setw(13) << ns[static_cast<size_t>(quantile * static_cast<double>(count - 1))];
+        }
+        std::cout << std::setw(13) << ns.back();
+    }
+    std::cout << '\n';
+}
+
+/// Build `count` distinct names of the given distribution, in random order
+std::vector<std::string> make_names(size_t count, name_distribution distribution) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    switch (distribution) {
+    case name_distribution::numbered:
+        for (size_t i = 0; i < count; ++i) {
+            names.push_back("Contact " + std::to_string(i * 7919 % 1'000'000'007));
+        }
+        break;
+    case name_distribution::people: {
+        static const std::vector<std::string> first_names{
+            "Anna",   "Ben",   "Clara", "David",  "Emma",   "Felix", "Greta",  "Hannah", "Ida",    "Jonas",
+            "Karl",   "Lena",  "Marie", "Noah",   "Olivia", "Paul",  "Quinn",  "Rosa",   "Sophie", "Tom",
+            "Ulrike", "Volker", "Wanda", "Xaver", "Yvonne", "Zoe",   "Elias",  "Mia",    "Leon",   "Lina"};
+        static const std::vector<std::string> last_names{
+            "Mueller",  "Schmidt", "Schneider", "Fischer", "Weber",  "Meyer",  "Wagner",  "Becker",
+            "Schulz",  "Hoffmann", "Schaefer",  "Koch",    "Bauer",  "Richter", "Klein",  "Wolf",
+            "Schroeder", "Neumann", "Schwarz",  "Zimmermann", "Braun", "Krueger", "Hofmann", "Hartmann",
+            "Lange",   "Schmitt", "Werner",    "Schmitz", "Krause", "Meier",  "Lehmann", "Schmid"};
+        // rank r is drawn with a weight of 1 / r, like names in a real directory
+        auto skewed = [](const std::vector<std::string>& list) {
+            std::vector<double> weights(list.size());
+            for (size_t r = 0; r < list.size(); ++r) {
+                weights[r] = 1.0 / static_cast<double>(r + 1);
+            }
+            return std::discrete_distribution<size_t>(weights.begin(), weights.end());
+        };
+        auto first = skewed(first_names);
+        auto last = skewed(last_names);
+        std::mt19937_64 rng{7};
+        std::unordered_map<std::string, size_t> seen;
+        for (size_t i = 0; i < count; ++i) {
+            std::string name = first_names[first(rng)] + " " + last_names[last(rng)];
+            size_t repeats = seen[name]++;
+            names.push_back(repeats == 0 ? name : name + " " + std::to_string(repeats + 1));
+        }
+        break;
+    }
+    case name_distribution::prefixed:
+        for (size_t i = 0; i < count; ++i) {
+            names.push_back("Sales department, Berlin office, desk " + std::to_string(i * 7919 % 1'000'000'007));
+        }
+        break;
+    }
+    return names;
+}
+
+contact_list::number_t make_number(size_t i) {
+    return static_cast<contact_list::number_t>(4'900'000'000 + i);
+}
+
+/// A number for `i` in random order, so the number index is not only appended to.
+/// Numbers of different `i` may be the same, as in a real directory.
+contact_list::number_t scrambled_number(size_t i) {
+    return static_cast<contact_list::number_t>(4'900'000'000 + ((i * 0x9E3779B97F4A7C15ull) >> 34));
+}
+
+void run(size_t contacts, name_distribution distribution) {
+    std::vector<std::string> names = make_names(contacts, distribution);
+
+    // look up contacts in random order, so the cache does not help
+    std::mt19937_64 rng{42};
+    std::vector<size_t> order(std::min<size_t>(contacts, 100'000));
+    for (size_t& o : order) {
+        o = rng() % contacts;
+    }
+
+    contact_list::storage s;
+    report("add", contacts, contacts, [&](size_t i) { contact_list::add(s, names[i], make_number(i)); });
+    report("bulk_add", contacts, 1, [&](size_t) {
+        std::vector<contact_list::entry> entries;
+        entries.reserve(contacts);
+        for (size_t i = 0; i < contacts; ++i) {
+            entries.emplace_back(names[i], make_number(i));
+        }
+        contact_list::storage bulk;
+        sink = contact_list::bulk_add(bulk, entries).size();
+    });
+    {
+        contact_list::storage scrambled;
+        report("add, random numbers", contacts, contacts,
+               [&](size_t i) { contact_list::add(scrambled, names[i], scrambled_number(i)); });
+    }
+    report("bulk_add, random numbers", contacts, 1, [&](size_t) {
+        std::vector<contact_list::entry> entries;
+        entries.reserve(contacts);
+        for (size_t i = 0; i < contacts; ++i) {
+            entries.emplace_back(names[i], scrambled_number(i));
+        }
+        contact_list::storage bulk;
+        sink = contact_list::bulk_add(bulk, entries).size();
+    });
+    report("add duplicate", contacts, order.size(),
+           [&](size_t i) { sink = contact_list::add(s, names[order[i]], 0); });
+    report("get_number_by_name", contacts, order.size(),
+           [&](size_t i) { sink = static_cast<size_t>(contact_list::get_number_by_name(s, names[order[i]])); });
+    report("get_name_by_number", contacts, order.size(),
+           [&](size_t i) { sink = contact_list::get_name_by_number(s, make_number(order[i])).size(); });
+    report("number range of 100", contacts, order.size(), [&](size_t i) {
+        sink = contact_list::get_names_by_number_range(s, make_number(order[i]), make_number(order[i] + 100)).size();
+    });
+    report("get_number_by_name miss", contacts, order.size(),
+           [&](size_t i) { sink = static_cast<size_t>(contact_list::get_number_by_name(s, "nobody " + std::to_string(i))); });
+    contact_list::search_index index;
+    report("build_search_index", contacts, 1, [&](size_t) { index = contact_list::build_search_index(s); });
+    report("find_by_prefix", contacts, order.size(), [&](size_t i) {
+        sink = contact_list::find_by_prefix(s, index, std::string_view{names[order[i]]}.substr(0, 11), 10).size();
+    });
+    report("find_similar 1", contacts, std::min<size_t>(order.size(), 1000), [&](size_t i) {
+        std::string typo = names[order[i]];
+        typo[typo.size() / 2] = 'x';
+        sink = contact_list::find_similar(s, index, typo, 1, 10).size();
+    });
+    report("find_similar 2", contacts, std::min<size_t>(order.size(), 1000), [&](size_t i) {
+        std::string typo = names[order[i]];
+        typo.erase(typo.size() / 2, 1);
+        typo[typo.size() / 3] = 'x';
+        sink = contact_list::find_similar(s, index, typo, 2, 10).size();
+    });
+
+    report("to_string", contacts, 1, [&](size_t) { sink = contact_list::to_string(s).size(); });
+    std::string snapshot;
+    report("save", contacts, 1, [&](size_t) {
+        std::ostringstream out;
+        contact_list::save(s, out);
+        snapshot = std::move(out).str();
+    });
+    report("load", contacts, 1, [&](size_t) {
+        std::istringstream in{snapshot};
+        sink = contact_list::size(contact_list::load(in));
+    });
+
+    contact_list::storage unsorted = s;
+    report("sort", contacts, 1, [&](size_t) { contact_list::sort(s); });
+    report("sort parallel", contacts, 1,
+           [&](size_t) { contact_list::sort(unsorted, contact_list::sort_mode::parallel); });
+    using contact_list::remove_mode;
+    for (auto [mode, name] : {std::pair{remove_mode::shift, "remove shift"}, std::pair{remove_mode::swap, "remove swap"},
+                              std::pair{remove_mode::tombstone, "remove tombstone"}}) {
+        contact_list::storage copy = s;
+        report(name, contacts, std::min<size_t>(contacts, 100),
+               [&](size_t i) { sink = contact_list::remove(copy, names[i * (contacts / 100)], mode); });
+    }
+}
+
+/// Time `threads` threads doing `ops` operations each, 9 of 10 lookups and the rest adds and removes
+template <typename Add, typename Lookup, typename Remove>
+double mixed_load(size_t threads, size_t ops, Add add, Lookup lookup, Remove remove) {
+    auto start = clock_type::now();
+    {
+        std::vector<std::jthread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([=] {
+                std::mt19937_64 rng{t};
+                for (size_t i = 0; i < ops; ++i) {
+                    size_t r = rng();
+                    if (r % 10 != 0) {
+                        lookup(r >> 8);
+                    }
+                    else if (r % 20 == 0) {
+                        add(t, i);
+                    }
+                    else {
+                        remove(t, i - 1);
+                    }
+                }
+            });
+        }
+    }
+    auto stop = clock_type::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(threads * ops);
+}
+
+/// Compare one mutex around a storage with the sharded concurrent_storage
+void contention(size_t contacts, name_distribution distribution) {
+    std::vector<std::string> names = make_names(contacts, distribution);
+    auto thread_name = [](size_t t, size_t i) { return "thread " + std::to_string(t) + " " + std::to_string(i); };
+
+    std::cout << "\nmixed load on " << contacts << " contacts, 90% lookups\n"
+              << std::left << std::setw(10) << "threads" << std::right << std::setw(16) << "global mutex"
+              << std::setw(16) << "sharded\n";
+    constexpr size_t ops = 200'000;
+    for (size_t threads : {1, 2, 4, 8, 16}) {
+        contact_list::storage plain;
+        std::mutex mutex;
+        contact_list::concurrent_storage sharded;
+        for (size_t i = 0; i < contacts; ++i) {
+            contact_list::add(plain, names[i], scrambled_number(i));
+            contact_list::add(sharded, names[i], scrambled_number(i));
+        }
+
+        double global_ns = mixed_load(
+            threads, ops,
+            [&](size_t t, size_t i) {
+                std::string name = thread_name(t, i);
+                std::lock_guard lock{mutex};
+                contact_list::add(plain, name, scrambled_number(t * ops + i));
+            },
+            [&](size_t i) {
+                std::lock_guard lock{mutex};
+                sink = static_cast<size_t>(contact_list::get_number_by_name(plain, names[i % contacts]));
+            },
+            [&](size_t t, size_t i) {
+                std::string name = thread_name(t, i);
+                std::lock_guard lock{mutex};
+                contact_list::remove(plain, name, contact_list::remove_mode::tombstone);
+            });
+        double sharded_ns = mixed_load(
+            threads, ops,
+            [&](size_t t, size_t i) { contact_list::add(sharded, thread_name(t, i), scrambled_number(t * ops + i)); },
+            [&](size_t i) {
+                sink = static_cast<size_t>(contact_list::get_number_by_name(sharded, names[i % contacts]));
+            },
+            [&](size_t t, size_t i) { contact_list::remove(sharded, thread_name(t, i)); });
+        std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(13) << global_ns << " ns" << std::setw(13) << sharded_ns << " ns\n";
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t max_contacts = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::string distribution_name = argc > 2 ? argv[2] : "numbered";
+    name_distribution distribution;
+    if (distribution_name == "numbered") {
+        distribution = name_distribution::numbered;
+    }
+    else if (distribution_name == "people") {
+        distribution = name_distribution::people;
+    }
+    else if (distribution_name == "prefixed") {
+        distribution = name_distribution::prefixed;
+    }
+    else {
+        std::cerr << "usage: contact_bench [max contacts] [numbered|people|prefixed]\n";
+        return 1;
+    }
+
+    clock_overhead = measure_clock_overhead();
+    std::cout << distribution_name << " names, " << std::fixed << std::setprecision(0) << clock_overhead
+              << " ns clock overhead subtracted\n";
+    print_header();
+    for (size_t contacts = 1000; contacts <= max_contacts; contacts *= 10) {
+        run(contacts, distribution);
+    }
+    contention(std::min<size_t>(max_contacts, 100'000), distribution);
+    return 0;
+}
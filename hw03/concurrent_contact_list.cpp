@@ -0,0 +1,222 @@
+#include "concurrent_contact_list.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace contact_list{
+namespace {
+
+/**
+ * The index of the shard a name belongs to.
+ * It is chosen by the top bits of the hash, the shard's name index uses the bottom ones.
+ */
+size_t shard_index(std::string_view name){
+    size_t hash = name_hash{}(name);
+    return hash >> (8 * sizeof(size_t) - concurrent_storage::shard_bits);
+}
+
+
+/**
+ * The shard a name belongs to.
+ */
+template <typename Storage>
+auto& shard_of(Storage& contacts, std::string_view name){
+    return contacts.shards[shard_index(name)];
+}
+} // namespace
+
+
+/**
+ * Given a contact storage, create a new contact entry by name and number.
+ */
+bool add(concurrent_storage& contacts, std::string_view name, number_t number){
+    auto& shard = shard_of(contacts, name);
+    std::unique_lock lock{shard.mutex};
+    return add(shard.contacts, name, number);
+}
+
+
+/**
+ * Given a contact storage, how many contacts are currently stored?
+ */
+size_t size(const concurrent_storage& contacts){
+    size_t count = 0;
+    for(const auto& shard : contacts.shards){
+        std::shared_lock lock{shard.mutex};
+        count += size(shard.contacts);
+    }
+    return count;
+}
+
+
+/**
+ * Fetch a contact number from storage given a name.
+ */
+number_t get_number_by_name(concurrent_storage& contacts, std::string_view name){
+    auto& shard = shard_of(contacts, name);
+    std::shared_lock lock{shard.mutex};
+    return get_number_by_name(shard.contacts, name);
+}
+
+
+/**
+ * Return a string representing the contact list, ordered by name.
+ */
+std::string to_string(const concurrent_storage& contacts){
+    // copy all contacts while holding the locks, sort them after releasing them.
+    // locking in shard order everywhere rules out deadlocks.
+    storage copy;
+    {
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        for(const auto& shard : contacts.shards){
+            locks.emplace_back(shard.mutex);
+        }
+        for(const auto& shard : contacts.shards){
+            size_t names_size = shard.contacts.names.size();
+            for(size_t i=0; i<names_size; i++){
+                std::string_view name = name_at(shard.contacts, i);
+                if(name.empty()){
+                    continue;
+                }
+                auto extra = shard.contacts.extra_numbers.find(i);
+                if(extra != shard.contacts.extra_numbers.end()){
+                    copy.extra_numbers.emplace(copy.names.size(), extra->second);
+                }
+                copy.names.push_back({static_cast<uint32_t>(copy.name_chars.size()), static_cast<uint32_t>(name.size())});
+                copy.name_chars.append(name);
+                copy.numbers.push_back(shard.contacts.numbers[i]);
+            }
+        }
+    }
+
+    std::vector<size_t> order(copy.names.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&copy](size_t a, size_t b){return name_at(copy, a) < name_at(copy, b);});
+
+    // to_string only needs the names and numbers, the indexes stay empty
+    storage sorted;
+    sorted.name_chars = std::move(copy.name_chars);
+    for(size_t slot : order){
+        auto extra = copy.extra_numbers.find(slot);
+        if(extra != copy.extra_numbers.end()){
+            sorted.extra_numbers.emplace(sorted.names.size(), std::move(extra->second));
+        }
+        sorted.names.push_back(copy.names[slot]);
+        sorted.numbers.push_back(copy.numbers[slot]);
+    }
+    return to_string(sorted);
+}
+
+
+/**
+ * Remove a contact by name from the contact list.
+ */
+bool remove(concurrent_storage& contacts, std::string_view name){
+    auto& shard = shard_of(contacts, name);
+    std::unique_lock lock{shard.mutex};
+    // the order inside a shard is never visible, so leaving a gap is fine and keeps the lock short
+    return remove(shard.contacts, name, remove_mode::tombstone);
+}
+
+
+/**
+ * Get the name for a given number.
+ */
+std::string get_name_by_number(concurrent_storage& contacts, number_t number){
+    // the number can be in any shard
+    std::string found;
+    for(auto& shard : contacts.shards){
+        std::shared_lock lock{shard.mutex};
+        const auto& index = shard.contacts.number_index;
+        auto first = index.lower_bound(std::pair<number_t, uint32_t>{number, 0});
+        for(; first != index.end() && first->first == number; ++first){
+            std::string_view name = name_at(shard.contacts, first->second);
+            if(found.empty() || name < found){
+                found = name;
+            }
+        }
+    }
+    return found;
+}
+
+
+/**
+ * Add many contacts at once, each shard is locked once for all of its names.
+ */
+std::vector<size_t> bulk_add(concurrent_storage& contacts, std::span<const entry> entries){
+    // positions of the entries of each shard, in order, so repeated names are rejected like in one storage
+    std::array<std::vector<size_t>, concurrent_storage::shard_count> positions;
+    for(size_t i=0; i<entries.size(); i++){
+        positions[shard_index(entries[i].first)].push_back(i);
+    }
+
+    std::vector<size_t> rejected;
+    std::vector<entry> shard_entries;
+    for(size_t s=0; s<concurrent_storage::shard_count; s++){
+        if(positions[s].empty()){
+            continue;
+        }
+        shard_entries.clear();
+        for(size_t i : positions[s]){
+            shard_entries.push_back(entries[i]);
+        }
+        auto& shard = contacts.shards[s];
+        std::unique_lock lock{shard.mutex};
+        for(size_t r : bulk_add(shard.contacts, shard_entries)){
+            rejected.push_back(positions[s][r]);
+        }
+    }
+    std::sort(rejected.begin(), rejected.end());
+    return rejected;
+}
+
+
+/**
+ * Give an existing contact one more number.
+ */
+bool add_number(concurrent_storage& contacts, std::string_view name, number_t number){
+    auto& shard = shard_of(contacts, name);
+    std::unique_lock lock{shard.mutex};
+    return add_number(shard.contacts, name, number);
+}
+
+
+/**
+ * Remove one of the numbers of a contact.
+ */
+bool remove_number(concurrent_storage& contacts, std::string_view name, number_t number){
+    auto& shard = shard_of(contacts, name);
+    std::unique_lock lock{shard.mutex};
+    return remove_number(shard.contacts, name, number);
+}
+
+
+/**
+ * Fetch all numbers of a contact.
+ */
+std::vector<number_t> get_numbers_by_name(concurrent_storage& contacts, std::string_view name){
+    auto& shard = shard_of(contacts, name);
+    std::shared_lock lock{shard.mutex};
+    return get_numbers_by_name(shard.contacts, name);
+}
+
+
+/**
+ * Fetch the numbers in [first, last) and the names of their contacts.
+ */
+std::vector<std::pair<number_t, std::string>> get_names_by_number_range(concurrent_storage& contacts,
+                                                                        number_t first, number_t last){
+    std::vector<std::pair<number_t, std::string>> found;
+    for(auto& shard : contacts.shards){
+        std::shared_lock lock{shard.mutex};
+        auto part = get_names_by_number_range(shard.contacts, first, last);
+        found.insert(found.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "contact_list.h"
+
+
+namespace contact_list {
+
+
+/**
+ * contact list which many threads can use at the same time.
+ *
+ * the contacts are split into shards by the hash of their name, each shard is a
+ * `storage` guarded by its own reader-writer lock. lookups of different threads only
+ * share a lock and adds or removes only block the one shard the name belongs to.
+ *
+ * a sharded list has no overall insertion order, so it differs from a `storage` wherever
+ * that order shows:
+ * - to_string() lists the contacts ordered by name, so there is no sort().
+ * - get_name_by_number() returns the alphabetically first of several contacts with the number,
+ *   not the one added first.
+ * - get_names_by_number_range() orders contacts with the same number by name.
+ * - remove() has no remove_mode, it leaves a gap in the shard which is closed later.
+ */
+struct concurrent_storage {
+    static constexpr size_t shard_bits = 4;
+    static constexpr size_t shard_count = size_t{1} << shard_bits;
+
+    /**
+     * one part of the contact list and its lock.
+     * aligned to a cache line, so threads using neighboring shards do not slow each other down.
+     */
+    struct alignas(64) shard {
+        mutable std::shared_mutex mutex;
+        storage contacts;
+    };
+
+    std::array<shard, shard_count> shards;
+};
+
+
+/**
+ * Given a contact storage, create a new contact entry by name and number.
+ */
+bool add(concurrent_storage& contacts, std::string_view name, number_t number);
+
+
+/**
+ * Given a contact storage, how many contacts are currently stored?
+ * Other threads may change the number while it is counted.
+ */
+size_t size(const concurrent_storage& contacts);
+
+
+/**
+ * Fetch a contact number from storage given a name.
+ */
+number_t get_number_by_name(concurrent_storage& contacts, std::string_view name);
+
+
+/**
+ * Return a string representing the contact list, ordered by name.
+ * All shards are locked for reading at once, so it shows the list at one point in time.
+ */
+std::string to_string(const concurrent_storage& contacts);
+
+
+/**
+ * Remove a contact by name from the contact list.
+ */
+bool remove(concurrent_storage& contacts, std::string_view name);
+
+
+/**
+ * Get the name for a given number.
+ * If several contacts have this number, the alphabetically first name is returned.
+ */
+std::string get_name_by_number(concurrent_storage& contacts, number_t number);
+
+
+/**
+ * Add many contacts at once, each shard is locked once for all of its names.
+ * Return the positions of the rejected entries in ascending order, like bulk_add() of a storage.
+ */
+std::vector<size_t> bulk_add(concurrent_storage& contacts, std::span<const entry> entries);
+
+
+/**
+ * Give an existing contact one more number.
+ * Return false if there is no contact with this name or it has this number already.
+ */
+bool add_number(concurrent_storage& contacts, std::string_view name, number_t number);
+
+
+/**
+ * Remove one of the numbers of a contact, see remove_number() of a storage.
+ */
+bool remove_number(concurrent_storage& contacts, std::string_view name, number_t number);
+
+
+/**
+ * Fetch all numbers of a contact, the first one is the one get_number_by_name() returns.
+ */
+std::vector<number_t> get_numbers_by_name(concurrent_storage& contacts, std::string_view name);
+
+
+/**
+ * Fetch the numbers in the range [first, last) with the names of their contacts,
+ * ordered by number and then by name.
+ * The shards are searched one after the other, so it does not show a single point in time.
+ */
+std::vector<std::pair<number_t, std::string>> get_names_by_number_range(concurrent_storage& contacts,
+                                                                        number_t first, number_t last);
+
+
+} // namespace contact_list
@@ -1,30 +1,401 @@
 #include "contact_list.h"
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <limits>
 #include <numeric>
-#include <sstream>
-#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
 
 namespace contact_list{
-// TODO create implementation here!
+namespace {
+
+/**
+ * The number index entry of number for the contact in slot.
+ */
+std::pair<number_t, uint32_t> number_entry(number_t number, size_t slot){
+    return {number, static_cast<uint32_t>(slot)};
+}
+
+
+/**
+ * Find the number index entry of the contact in the given slot, or the end if it does not have the number.
+ */
+auto find_number_slot(storage& contacts, number_t number, size_t slot){
+    return contacts.number_index.find(number_entry(number, slot));
+}
+
+
+/**
+ * Add a number of the contact in slot to the number index.
+ * numbers above all others, like increasing ones, go to the end without a search.
+ */
+void insert_number(storage& contacts, number_t number, size_t slot){
+    contacts.number_index.insert(contacts.number_index.end(), number_entry(number, slot));
+}
+
+
+/**
+ * Point the number index entry of number from old_slot to new_slot.
+ * The entry is taken out and put back in its new place, without allocating.
+ */
+void reslot_number(storage& contacts, number_t number, size_t old_slot, size_t new_slot){
+    auto entry = contacts.number_index.extract(number_entry(number, old_slot));
+    entry.value().second = static_cast<uint32_t>(new_slot);
+    contacts.number_index.insert(std::move(entry));
+}
+
+
+/**
+ * Position in the name index of the entry for name, or of the unused entry where it belongs.
+ * hash has to be name_hash{}(name). The name index must not be empty.
+ */
+size_t probe(const storage& contacts, std::string_view name, size_t hash){
+    size_t mask = contacts.name_index.size() - 1;
+    for(size_t pos = hash & mask;; pos = (pos + 1) & mask){
+        uint32_t entry = contacts.name_index[pos];
+        if(entry == 0 || name_at(contacts, entry - 1) == name){
+            return pos;
+        }
+    }
+}
+
+
+size_t probe(const storage& contacts, std::string_view name){
+    return probe(contacts, name, name_hash{}(name));
+}
+
+
+/**
+ * Resize the name index to the given power of two and insert all contacts again.
+ */
+void rehash(storage& contacts, size_t table_size){
+    contacts.name_index.assign(table_size, 0);
+    size_t names_size = contacts.names.size();
+    for(size_t i=0; i<names_size; i++){
+        if(contacts.names[i].length != 0){
+            contacts.name_index[probe(contacts, name_at(contacts, i))] = static_cast<uint32_t>(i + 1);
+        }
+    }
+}
+
+
+/**
+ * Rebuild both indexes from the names and numbers.
+ * Return false if a name occurs more than once.
+ */
+bool rebuild_indexes(storage& contacts){
+    size_t table_size = 16;
+    while(table_size < 2 * size(contacts)){
+        table_size *= 2;
+    }
+    contacts.name_index.assign(table_size, 0);
+    contacts.number_index.clear();
+    std::vector<std::pair<number_t, uint32_t>> numbers;
+    numbers.reserve(size(contacts));
+    size_t names_size = contacts.names.size();
+    for(size_t i=0; i<names_size; i++){
+        if(contacts.names[i].length == 0){
+            continue;
+        }
+        size_t pos = probe(contacts, name_at(contacts, i));
+        if(contacts.name_index[pos] != 0){
+            return false;
+        }
+        contacts.name_index[pos] = static_cast<uint32_t>(i + 1);
+        numbers.push_back(number_entry(contacts.numbers[i], i));
+    }
+    for(const auto& [slot, extra] : contacts.extra_numbers){
+        for(number_t number : extra){
+            numbers.push_back(number_entry(number, slot));
+        }
+    }
+    // filling the index in order puts each entry right at the end
+    std::sort(numbers.begin(), numbers.end());
+    contacts.number_index.insert(numbers.begin(), numbers.end());
+    return true;
+}
+
+
+/**
+ * Store a contact in a new slot, pos is the free entry of the name index probe() found for name.
+ * The number index is left to the caller, so many contacts can be merged into it at once.
+ */
+void append(storage& contacts, size_t pos, std::string_view name, number_t number){
+    size_t slot = contacts.names.size();
+    contacts.names.push_back({static_cast<uint32_t>(contacts.name_chars.size()), static_cast<uint32_t>(name.size())});
+    contacts.name_chars.append(name);
+    contacts.numbers.push_back(number);
+    contacts.name_index[pos] = static_cast<uint32_t>(slot + 1);
+    contacts.generation++;
+}
+
+
+/**
+ * Number of characters of the decimal representation of number.
+ */
+size_t number_length(number_t number){
+    char digits[24];
+    return static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), number).ptr - digits);
+}
+
+
+/**
+ * First bytes of a binary snapshot, followed by the arrays.
+ * Version 1 snapshots end after the name characters, version 2 adds the extra numbers.
+ */
+struct snapshot_header {
+    char magic[4] = {'C', 'L', 'S', 'T'};
+    uint32_t version = 2;
+    uint64_t contacts = 0;
+    uint64_t chars = 0;
+};
+
+
+template <typename T>
+void write_array(std::ostream& out, const T* data, size_t count){
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+
+template <typename T>
+void read_array(std::istream& in, T* data, size_t count){
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    if(!in){
+        throw std::runtime_error("invalid contact list snapshot");
+    }
+}
+
+
+/**
+ * Read count elements into out, growing it by at most one MiB at a time.
+ * The counts come from the input, so a corrupted one fails at the end of the input
+ * instead of allocating memory for data which is not there.
+ */
+template <typename Container>
+void read_chunked(std::istream& in, Container& out, size_t count){
+    constexpr size_t chunk = (size_t{1} << 20) / sizeof(typename Container::value_type);
+    out.clear();
+    while(out.size() < count){
+        size_t done = out.size();
+        size_t n = std::min(chunk, count - done);
+        out.resize(done + n);
+        read_array(in, out.data() + done, n);
+    }
+}
+
+
+/**
+ * Remove the entry at pos from the name index. The following entries of the probe sequence
+ * are moved back, so no lookup passes an unused entry before reaching its name.
+ */
+void erase_name_entry(storage& contacts, size_t pos){
+    size_t mask = contacts.name_index.size() - 1;
+    size_t hole = pos;
+    for(size_t next = (hole + 1) & mask; contacts.name_index[next] != 0; next = (next + 1) & mask){
+        size_t home = name_hash{}(name_at(contacts, contacts.name_index[next] - 1)) & mask;
+        // the entry can fill the hole unless its home lies cyclically between hole and next
+        if(((next - home) & mask) >= ((next - hole) & mask)){
+            contacts.name_index[hole] = contacts.name_index[next];
+            hole = next;
+        }
+    }
+    contacts.name_index[hole] = 0;
+}
+
+
+/**
+ * Update the indexes after the contact in slot old_slot was moved to new_slot.
+ * Gaps of removed contacts are in no index and are skipped.
+ */
+void move_slot(storage& contacts, size_t old_slot, size_t new_slot){
+    std::string_view name = name_at(contacts, new_slot);
+    if(name.empty()){
+        return;
+    }
+    contacts.name_index[probe(contacts, name)] = static_cast<uint32_t>(new_slot + 1);
+    reslot_number(contacts, contacts.numbers[new_slot], old_slot, new_slot);
+    auto extra = contacts.extra_numbers.extract(old_slot);
+    if(!extra.empty()){
+        for(number_t number : extra.mapped()){
+            reslot_number(contacts, number, old_slot, new_slot);
+        }
+        extra.key() = new_slot;
+        contacts.extra_numbers.insert(std::move(extra));
+    }
+}
+
+
+/**
+ * Point all index entries to the new slots after the contacts were reordered,
+ * new_slot holds the new slot for each old one.
+ */
+void remap_slots(storage& contacts, const std::vector<size_t>& new_slot){
+    for(uint32_t& entry : contacts.name_index){
+        if(entry != 0){
+            entry = static_cast<uint32_t>(new_slot[entry - 1] + 1);
+        }
+    }
+    // the entries of the number index are taken out, changed and put back, reusing their nodes
+    using number_node = decltype(contacts.number_index)::node_type;
+    std::vector<number_node> entries;
+    entries.reserve(contacts.number_index.size());
+    while(!contacts.number_index.empty()){
+        entries.push_back(contacts.number_index.extract(contacts.number_index.begin()));
+    }
+    for(auto& entry : entries){
+        entry.value().second = static_cast<uint32_t>(new_slot[entry.value().second]);
+    }
+    // closing gaps keeps the order of the slots, only sorting the contacts mixes them up
+    auto by_entry = [](const number_node& a, const number_node& b){return a.value() < b.value();};
+    if(!std::is_sorted(entries.begin(), entries.end(), by_entry)){
+        std::sort(entries.begin(), entries.end(), by_entry);
+    }
+    for(auto& entry : entries){
+        contacts.number_index.insert(contacts.number_index.end(), std::move(entry));
+    }
+    if(!contacts.extra_numbers.empty()){
+        std::unordered_map<size_t, std::vector<number_t>> extra_numbers;
+        for(auto& [slot, numbers] : contacts.extra_numbers){
+            extra_numbers.emplace(new_slot[slot], std::move(numbers));
+        }
+        contacts.extra_numbers = std::move(extra_numbers);
+    }
+}
+
+
+/**
+ * Copy the names into a fresh arena in slot order, dropping the characters of removed names.
+ */
+void rewrite_chars(storage& contacts){
+    std::string chars;
+    chars.reserve(contacts.name_chars.size() - contacts.garbage_chars);
+    for(name_ref& ref : contacts.names){
+        chars.append(contacts.name_chars, ref.offset, ref.length);
+        ref.offset = static_cast<uint32_t>(chars.size() - ref.length);
+    }
+    contacts.name_chars = std::move(chars);
+    contacts.garbage_chars = 0;
+}
+
+
+/**
+ * Sort the slot numbers in order with one thread per chunk, then merge the sorted chunks pairwise.
+ */
+template <typename Compare>
+void parallel_sort(std::vector<size_t>& order, Compare less){
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunk = (order.size() + threads - 1) / threads;
+    if(threads == 1 || chunk < 4096){
+        std::sort(order.begin(), order.end(), less);
+        return;
+    }
+    auto at = [&order](size_t pos){return order.begin() + static_cast<std::ptrdiff_t>(std::min(pos, order.size()));};
+    {
+        std::vector<std::jthread> workers;
+        for(size_t begin=0; begin<order.size(); begin+=chunk){
+            workers.emplace_back([=]{std::sort(at(begin), at(begin + chunk), less);});
+        }
+    }
+    for(; chunk<order.size(); chunk*=2){
+        std::vector<std::jthread> workers;
+        for(size_t begin=0; begin+chunk<order.size(); begin+=2*chunk){
+            workers.emplace_back([=]{std::inplace_merge(at(begin), at(begin + chunk), at(begin + 2*chunk), less);});
+        }
+    }
+}
+} // namespace
+
 
 /**
  * Given a contact storage, create a new contact entry by name and number.
  */
 
 bool add(storage& contacts, std::string_view name, number_t number){
-    if(std::find(contacts.names.begin(), contacts.names.end(), name) != contacts.names.end()){
+    if(name.empty()){
         return false;
     }
-    else{
-        if (name.empty()){
-            return false;
+    // keep at most half of the name index in use
+    if(2 * (size(contacts) + 1) > contacts.name_index.size()){
+        rehash(contacts, std::max<size_t>(16, 2 * contacts.name_index.size()));
+    }
+    size_t pos = probe(contacts, name);
+    if(contacts.name_index[pos] != 0){
+        return false;
+    }
+    if(contacts.name_chars.size() + name.size() > std::numeric_limits<uint32_t>::max()
+       || contacts.names.size() >= std::numeric_limits<uint32_t>::max()){
+        throw std::length_error("contact list is full");
+    }
+    append(contacts, pos, name, number);
+    insert_number(contacts, number, contacts.names.size() - 1);
+    return true;
+}
+
+
+/**
+ * Add many contacts at once, growing storage and indexes only once.
+ */
+std::vector<size_t> bulk_add(storage& contacts, std::span<const entry> entries){
+    // checked for all names, even those rejected later, so nothing is added if it does not fit
+    size_t chars = 0;
+    for(const auto& [name, number] : entries){
+        chars += name.size();
+    }
+    size_t limit = std::numeric_limits<uint32_t>::max();
+    if(entries.size() > limit - contacts.names.size() || chars > limit - contacts.name_chars.size()){
+        throw std::length_error("contact list is full");
+    }
+
+    size_t table_size = std::max<size_t>(16, contacts.name_index.size());
+    while(table_size < 2 * (size(contacts) + entries.size())){
+        table_size *= 2;
+    }
+    if(table_size != contacts.name_index.size()){
+        rehash(contacts, table_size);
+    }
+    contacts.names.reserve(contacts.names.size() + entries.size());
+    contacts.numbers.reserve(contacts.numbers.size() + entries.size());
+    contacts.name_chars.reserve(contacts.name_chars.size() + chars);
+
+    // the entries hit the name index in random places, so hashing ahead lets
+    // the entry of a later name be fetched from memory while this one is probed
+    constexpr size_t ahead = 16;
+    std::vector<size_t> hashes(entries.size());
+    for(size_t i=0; i<entries.size(); i++){
+        hashes[i] = name_hash{}(entries[i].first);
+    }
+
+    // names added before are in the name index already, so one probe finds
+    // existing contacts and repeated names alike
+    std::vector<size_t> rejected;
+    size_t first_slot = contacts.names.size();
+    for(size_t i=0; i<entries.size(); i++){
+#if defined(__GNUC__)
+        if(i + ahead < entries.size()){
+            __builtin_prefetch(&contacts.name_index[hashes[i + ahead] & (contacts.name_index.size() - 1)]);
         }
-        else{
-            contacts.numbers.push_back(number);
-            contacts.names.emplace_back(name);
-            return true;
-        }       
-    }   
+#endif
+        auto [name, number] = entries[i];
+        size_t pos = name.empty() ? 0 : probe(contacts, name, hashes[i]);
+        if(name.empty() || contacts.name_index[pos] != 0){
+            rejected.push_back(i);
+            continue;
+        }
+        append(contacts, pos, name, number);
+    }
+
+    // the new numbers are sorted first, so the index is walked front to back while they are inserted
+    std::vector<std::pair<number_t, uint32_t>> numbers;
+    numbers.reserve(contacts.names.size() - first_slot);
+    for(size_t slot=first_slot; slot<contacts.names.size(); slot++){
+        numbers.push_back(number_entry(contacts.numbers[slot], slot));
+    }
+    std::sort(numbers.begin(), numbers.end());
+    contacts.number_index.insert(numbers.begin(), numbers.end());
+    return rejected;
 }
 
 
@@ -32,7 +403,7 @@ bool add(storage& contacts, std::string_view name, number_t number){
  * Given a contact storage, how many contacts are currently stored?
  */
 size_t size(const storage& contacts){
-    return contacts.names.size();
+    return contacts.names.size() - contacts.tombstones;
 }
 
 
@@ -40,18 +411,14 @@ size_t size(const storage& contacts){
  * Fetch a contact number from storage given a name.
  */
 contact_list::number_t get_number_by_name(storage& contacts, std::string_view name){
-    //static_cast<std::string>(name);
-    //std::vector<int>::iterator it = std::find(contacts.names.begin(), contacts.names.end(), name);
-    int names_size = contacts.names.size();
-    for(int i=0; i<names_size; i++){
-        if(contacts.names.at(i) == name){
-            return contacts.numbers.at(i);
-        }
-        else{
-            continue;
-        }
+    if(contacts.name_index.empty()){
+        return -1;
     }
-    return -1;
+    uint32_t entry = contacts.name_index[probe(contacts, name)];
+    if(entry == 0){
+        return -1;
+    }
+    return contacts.numbers[entry - 1];
 }
 
 
@@ -59,35 +426,247 @@ contact_list::number_t get_number_by_name(storage& contacts, std::string_view na
  * Return a string representing the contact list.
  */
 std::string to_string(const storage& contacts){
+    // the size of the output is known up front, so it is written into one allocation
+    constexpr std::string_view separator = " - ";
+    constexpr std::string_view number_separator = ", ";
     size_t names_size = contacts.names.size();
-    std::stringstream buffer;
-    for(int i=0; i<names_size; i++){
-        buffer << contacts.names.at(i) <<  " - " << contacts.numbers.at(i) << "\n";
+    size_t total = 0;
+    for(size_t i=0; i<names_size; i++){
+        if(contacts.names[i].length != 0){
+            total += contacts.names[i].length + separator.size() + number_length(contacts.numbers[i]) + 1;
+        }
+    }
+    for(const auto& [slot, numbers] : contacts.extra_numbers){
+        for(number_t number : numbers){
+            total += number_separator.size() + number_length(number);
+        }
+    }
+
+    std::string s(total, '\0');
+    char* out = s.data();
+    for(size_t i=0; i<names_size; i++){
+        std::string_view name = name_at(contacts, i);
+        if(name.empty()){
+            continue;
+        }
+        out = std::copy(name.begin(), name.end(), out);
+        out = std::copy(separator.begin(), separator.end(), out);
+        out = std::to_chars(out, s.data() + s.size(), contacts.numbers[i]).ptr;
+        auto extra = contacts.extra_numbers.find(i);
+        if(extra != contacts.extra_numbers.end()){
+            for(number_t number : extra->second){
+                out = std::copy(number_separator.begin(), number_separator.end(), out);
+                out = std::to_chars(out, s.data() + s.size(), number).ptr;
+            }
+        }
+        *out++ = '\n';
     }
-    std::string s = buffer.str();
     return s;
 }
 
 
+/**
+ * Write a binary snapshot of the contact list to out.
+ */
+void save(const storage& contacts, std::ostream& out){
+    // layout: header, then the numbers, the name lengths and the name characters as arrays,
+    // then the count of extra numbers and for each the position of its contact and the number
+    snapshot_header header;
+    header.contacts = size(contacts);
+    header.chars = contacts.name_chars.size() - contacts.garbage_chars;
+
+    std::vector<number_t> numbers;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> extra_positions;
+    std::vector<number_t> extra_numbers;
+    numbers.reserve(header.contacts);
+    lengths.reserve(header.contacts);
+    size_t names_size = contacts.names.size();
+    for(size_t i=0; i<names_size; i++){
+        if(contacts.names[i].length == 0){
+            continue;
+        }
+        auto extra = contacts.extra_numbers.find(i);
+        if(extra != contacts.extra_numbers.end()){
+            for(number_t number : extra->second){
+                extra_positions.push_back(static_cast<uint32_t>(numbers.size()));
+                extra_numbers.push_back(number);
+            }
+        }
+        numbers.push_back(contacts.numbers[i]);
+        lengths.push_back(contacts.names[i].length);
+    }
+
+    write_array(out, &header, 1);
+    write_array(out, numbers.data(), numbers.size());
+    write_array(out, lengths.data(), lengths.size());
+    if(contacts.garbage_chars == 0){
+        write_array(out, contacts.name_chars.data(), contacts.name_chars.size());
+    }
+    else{
+        for(size_t i=0; i<names_size; i++){
+            std::string_view name = name_at(contacts, i);
+            write_array(out, name.data(), name.size());
+        }
+    }
+    uint64_t extra_count = extra_numbers.size();
+    write_array(out, &extra_count, 1);
+    write_array(out, extra_positions.data(), extra_positions.size());
+    write_array(out, extra_numbers.data(), extra_numbers.size());
+    if(!out){
+        throw std::runtime_error("could not write contact list snapshot");
+    }
+}
+
+
+/**
+ * Read a contact list from a binary snapshot written by save().
+ */
+storage load(std::istream& in){
+    snapshot_header header;
+    read_array(in, &header, 1);
+    snapshot_header expected;
+    if(std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version == 0 || header.version > expected.version
+       || header.contacts > std::numeric_limits<uint32_t>::max() || header.chars > std::numeric_limits<uint32_t>::max()){
+        throw std::runtime_error("invalid contact list snapshot");
+    }
+
+    storage contacts;
+    auto count = static_cast<size_t>(header.contacts);
+    std::vector<uint32_t> lengths;
+    read_chunked(in, contacts.numbers, count);
+    read_chunked(in, lengths, count);
+    read_chunked(in, contacts.name_chars, static_cast<size_t>(header.chars));
+    if(header.version >= 2){
+        uint64_t extra_count = 0;
+        read_array(in, &extra_count, 1);
+        if(extra_count > std::numeric_limits<uint32_t>::max()){
+            throw std::runtime_error("invalid contact list snapshot");
+        }
+        std::vector<uint32_t> positions;
+        std::vector<number_t> numbers;
+        read_chunked(in, positions, static_cast<size_t>(extra_count));
+        read_chunked(in, numbers, static_cast<size_t>(extra_count));
+        for(size_t i=0; i<positions.size(); i++){
+            if(positions[i] >= count){
+                throw std::runtime_error("invalid contact list snapshot");
+            }
+            contacts.extra_numbers[positions[i]].push_back(numbers[i]);
+        }
+    }
+
+    contacts.names.resize(count);
+    uint64_t offset = 0;
+    for(size_t i=0; i<count; i++){
+        if(lengths[i] == 0){
+            throw std::runtime_error("invalid contact list snapshot");
+        }
+        contacts.names[i] = name_ref{static_cast<uint32_t>(offset), lengths[i]};
+        offset += lengths[i];
+    }
+    if(offset != header.chars || !rebuild_indexes(contacts)){
+        throw std::runtime_error("invalid contact list snapshot");
+    }
+    return contacts;
+}
+
+
 /**
  * Remove a contact by name from the contact list.
+ * The others keep their order and no gap is left behind, like remove_mode::shift.
  */
 bool remove(storage& contacts, std::string_view name){
-    //std::vector<int>::iterator it = std::find(contacts.names.begin(), contacts.names.end(), name);
-    //if(it != contacts.names.end()){
-    int names_size = contacts.names.size();
-    std::vector<std::string> rname{};
-    for(int i=0; i<names_size; i++){
-        if(contacts.names.at(i) == name){
-            contacts.numbers.erase(contacts.numbers.begin()+i);
-            contacts.names.erase(contacts.names.begin()+i);
-            return true;
-        }
-        else{
-            continue;
+    return remove(contacts, name, remove_mode::shift);
+}
+
+
+/**
+ * Remove a contact by name from the contact list, using the given mode.
+ */
+bool remove(storage& contacts, std::string_view name, remove_mode mode){
+    if(contacts.name_index.empty()){
+        return false;
+    }
+    size_t pos = probe(contacts, name);
+    if(contacts.name_index[pos] == 0){
+        return false;
+    }
+    size_t slot = contacts.name_index[pos] - 1;
+    contacts.generation++;
+    erase_name_entry(contacts, pos);
+    contacts.number_index.erase(find_number_slot(contacts, contacts.numbers[slot], slot));
+    auto extra = contacts.extra_numbers.find(slot);
+    if(extra != contacts.extra_numbers.end()){
+        for(number_t number : extra->second){
+            contacts.number_index.erase(find_number_slot(contacts, number, slot));
         }
+        contacts.extra_numbers.erase(extra);
+    }
+    contacts.garbage_chars += contacts.names[slot].length;
+
+    switch(mode){
+    case remove_mode::shift: {
+        // all following contacts move one slot to the front
+        std::vector<size_t> new_slot(contacts.names.size());
+        std::iota(new_slot.begin(), new_slot.end(), size_t{0});
+        std::for_each(new_slot.begin()+slot, new_slot.end(), [](size_t& s){s--;});
+        remap_slots(contacts, new_slot);
+        contacts.numbers.erase(contacts.numbers.begin()+slot);
+        contacts.names.erase(contacts.names.begin()+slot);
+        break;
+    }
+    case remove_mode::swap: {
+        size_t last = contacts.names.size() - 1;
+        if(slot != last){
+            contacts.names[slot] = contacts.names[last];
+            contacts.numbers[slot] = contacts.numbers[last];
+            move_slot(contacts, last, slot);
+        }
+        contacts.names.pop_back();
+        contacts.numbers.pop_back();
+        break;
+    }
+    case remove_mode::tombstone:
+        contacts.names[slot] = name_ref{};
+        contacts.tombstones++;
+        break;
+    }
+
+    if(2 * contacts.tombstones > contacts.names.size() || 2 * contacts.garbage_chars > contacts.name_chars.size()){
+        compact(contacts);
+    }
+    return true;
+}
+
+
+/**
+ * Close the gaps left by removed contacts, keeping the order of the others.
+ */
+void compact(storage& contacts){
+    if(contacts.tombstones != 0 || contacts.garbage_chars != 0){
+        contacts.generation++;
+    }
+    if(contacts.tombstones != 0){
+        size_t names_size = contacts.names.size();
+        std::vector<size_t> new_slot(names_size);
+        size_t live = 0;
+        for(size_t i=0; i<names_size; i++){
+            if(contacts.names[i].length == 0){
+                continue;
+            }
+            contacts.names[live] = contacts.names[i];
+            contacts.numbers[live] = contacts.numbers[i];
+            new_slot[i] = live;
+            live++;
+        }
+        contacts.names.resize(live);
+        contacts.numbers.resize(live);
+        contacts.tombstones = 0;
+        remap_slots(contacts, new_slot);
+    }
+    if(contacts.garbage_chars != 0){
+        rewrite_chars(contacts);
     }
-    return false;
 }
 
 
@@ -95,21 +674,58 @@ bool remove(storage& contacts, std::string_view name){
  * Sort the contact list in-place by name.
  */
 void sort(storage& contacts){
-    //bool compareFunction (std::string a, std::string b){
-    //    return a<b;
-    //   };
-    std::vector<std::string> copy_names = contacts.names;
-    std::vector<number_t> copy_numbers = contacts.numbers;
-    std::sort(contacts.names.begin(), contacts.names.end(),[](const std::string & a, const std::string & b) -> bool{return a < b;});
-    int names_size = contacts.names.size();
-    for(int i=0; i<names_size; i++){
-        std::string old = copy_names.at(i);
-        for(int j=0; j<names_size; j++){
-            if(contacts.names.at(j) == old){
-                contacts.numbers.at(j) = copy_numbers.at(i);
-            }
+    sort(contacts, sort_mode::sequential);
+}
+
+
+/**
+ * Sort the contact list in-place by name, using the given mode.
+ */
+void sort(storage& contacts, sort_mode mode){
+    compact(contacts);
+    contacts.generation++;
+
+    // sort slot numbers instead of the contacts, order[i] is the slot of the i-th contact by name
+    size_t count = contacts.names.size();
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+    auto by_name = [&contacts](size_t a, size_t b){return name_at(contacts, a) < name_at(contacts, b);};
+    if(mode == sort_mode::parallel){
+        parallel_sort(order, by_name);
+    }
+    else{
+        std::sort(order.begin(), order.end(), by_name);
+    }
+
+    // the indexes only need the new slot of each old one
+    std::vector<size_t> new_slot(count);
+    for(size_t i=0; i<count; i++){
+        new_slot[order[i]] = i;
+    }
+    remap_slots(contacts, new_slot);
+
+    // apply the permutation cycle by cycle, every contact is moved exactly once
+    for(size_t start=0; start<count; start++){
+        if(order[start] == start){
+            continue;
         }
+        name_ref name = contacts.names[start];
+        number_t number = contacts.numbers[start];
+        size_t slot = start;
+        while(order[slot] != start){
+            size_t from = order[slot];
+            contacts.names[slot] = contacts.names[from];
+            contacts.numbers[slot] = contacts.numbers[from];
+            order[slot] = slot;
+            slot = from;
+        }
+        contacts.names[slot] = name;
+        contacts.numbers[slot] = number;
+        order[slot] = slot;
     }
+
+    // lay out the characters in the new order as well, so scanning the list reads memory front to back
+    rewrite_chars(contacts);
 }
 
 
@@ -117,12 +733,106 @@ void sort(storage& contacts){
  * Fetch a contact name from storage given a number.
  */
 std::string get_name_by_number(storage& contacts, number_t number){
-    int number_size = contacts.numbers.size();
-    for(int i=0; i<number_size; i++){
-        if(contacts.numbers.at(i) == number){
-            return contacts.names.at(i);
-        }
+    // several contacts may have this number, the entries are ordered by slot, so the first one is first in the list
+    auto found = contacts.number_index.lower_bound(number_entry(number, 0));
+    if(found == contacts.number_index.end() || found->first != number){
+        return "";
+    }
+    return std::string{name_at(contacts, found->second)};
+}
+
+
+/**
+ * Give an existing contact one more number.
+ */
+bool add_number(storage& contacts, std::string_view name, number_t number){
+    if(contacts.name_index.empty()){
+        return false;
+    }
+    uint32_t entry = contacts.name_index[probe(contacts, name)];
+    if(entry == 0){
+        return false;
     }
-    return "";
+    size_t slot = entry - 1;
+    if(find_number_slot(contacts, number, slot) != contacts.number_index.end()){
+        return false;
+    }
+    contacts.extra_numbers[slot].push_back(number);
+    insert_number(contacts, number, slot);
+    return true;
+}
+
+
+/**
+ * Remove one of the numbers of a contact.
+ */
+bool remove_number(storage& contacts, std::string_view name, number_t number){
+    if(contacts.name_index.empty()){
+        return false;
+    }
+    uint32_t entry = contacts.name_index[probe(contacts, name)];
+    if(entry == 0){
+        return false;
+    }
+    size_t slot = entry - 1;
+    auto extra = contacts.extra_numbers.find(slot);
+    if(extra == contacts.extra_numbers.end()){
+        return false;
+    }
+    auto index_entry = find_number_slot(contacts, number, slot);
+    if(index_entry == contacts.number_index.end()){
+        return false;
+    }
+    contacts.number_index.erase(index_entry);
+
+    // the first extra number takes the place of a removed first number
+    std::vector<number_t>& numbers = extra->second;
+    auto it = std::find(numbers.begin(), numbers.end(), number);
+    if(it == numbers.end()){
+        contacts.numbers[slot] = numbers.front();
+        it = numbers.begin();
+    }
+    numbers.erase(it);
+    if(numbers.empty()){
+        contacts.extra_numbers.erase(extra);
+    }
+    return true;
+}
+
+
+/**
+ * Fetch all numbers of a contact.
+ */
+std::vector<number_t> get_numbers_by_name(storage& contacts, std::string_view name){
+    if(contacts.name_index.empty()){
+        return {};
+    }
+    uint32_t entry = contacts.name_index[probe(contacts, name)];
+    if(entry == 0){
+        return {};
+    }
+    std::vector<number_t> numbers{contacts.numbers[entry - 1]};
+    auto extra = contacts.extra_numbers.find(entry - 1);
+    if(extra != contacts.extra_numbers.end()){
+        numbers.insert(numbers.end(), extra->second.begin(), extra->second.end());
+    }
+    return numbers;
+}
+
+
+/**
+ * Fetch the numbers in [first, last) and the names of their contacts.
+ */
+std::vector<std::pair<number_t, std::string>> get_names_by_number_range(storage& contacts, number_t first, number_t last){
+    std::vector<std::pair<number_t, std::string>> found;
+    if(first >= last){
+        return found;
+    }
+    auto begin = contacts.number_index.lower_bound(number_entry(first, 0));
+    auto end = contacts.number_index.lower_bound(number_entry(last, 0));
+    for(auto it=begin; it!=end; ++it){
+        found.emplace_back(it->first, name_at(contacts, it->second));
+    }
+    return found;
+}
 }
-}
\ No newline at end of file
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <concepts>
 #include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <ranges>
+#include <set>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
@@ -18,6 +27,27 @@ namespace contact_list {
 using number_t = int64_t;
 
 
+/**
+ * hashes names for the name index.
+ * it works on std::string_view, so looking up a name never creates a temporary string.
+ */
+struct name_hash {
+    size_t operator()(std::string_view name) const noexcept {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
+
+/**
+ * position of a name in `storage::name_chars`.
+ * a removed contact has length 0, real names are never empty.
+ */
+struct name_ref {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+
 /**
  * stores contacts by saving names and numbers.
  * be careful - these vectors have to be kept in sync!
@@ -27,10 +57,65 @@ using number_t = int64_t;
  */
 struct storage {
     std::vector<number_t> numbers;
-    std::vector<std::string> names;
+    std::vector<name_ref> names;
+
+    /**
+     * characters of all names back to back, `names` points into it.
+     * so all names live in one allocation instead of one string each.
+     */
+    std::string name_chars;
+
+    /**
+     * characters in `name_chars` of removed contacts, which are dropped by compact().
+     */
+    size_t garbage_chars = 0;
+
+    /**
+     * slot in `names` and `numbers` of each contact, by name.
+     * a hash table with linear probing, whose entries are slot + 1, or 0 if unused.
+     * the size is zero or a power of two, and at most half of the entries are used.
+     */
+    std::vector<uint32_t> name_index;
+
+    /**
+     * numbers of contacts beyond the one in `numbers`, by slot.
+     * most contacts have a single number, so they have no entry here.
+     */
+    std::unordered_map<size_t, std::vector<number_t>> extra_numbers;
+
+    /**
+     * number and slot in `names` and `numbers` of each contact, ordered by number and then slot.
+     * several contacts may share a number, so there is one entry per contact and number.
+     * it is ordered, so the numbers of a range are next to each other, and the first entry
+     * of a number belongs to the first contact in the list. adding and removing an entry takes
+     * O(log n) for any number.
+     */
+    std::set<std::pair<number_t, uint32_t>> number_index;
+
+    /**
+     * number of removed contacts whose slot was not compacted yet.
+     * removed contacts keep their slot with an empty name, and are in no index.
+     */
+    size_t tombstones = 0;
+
+    /**
+     * counts the changes to slots and names: adding, removing, compacting and sorting.
+     * structures referring to slots, like a search_index, remember it to notice when they are out of date.
+     */
+    uint64_t generation = 0;
 };
 
 
+/**
+ * Fetch the name of the contact in the given slot of the storage.
+ * The name is empty if the contact was removed.
+ */
+inline std::string_view name_at(const storage& contacts, size_t slot) {
+    name_ref ref = contacts.names[slot];
+    return std::string_view{contacts.name_chars.data() + ref.offset, ref.length};
+}
+
+
 
 // functions for dealing with the contact list storage - this is your contact list API.
 // you have to implement them - and we check if they behave as expected.
@@ -41,6 +126,57 @@ struct storage {
 bool add(storage& contacts, std::string_view name, number_t number);
 
 
+/**
+ * one contact for bulk_add().
+ */
+using entry = std::pair<std::string_view, number_t>;
+
+
+/**
+ * Add many contacts at once, like calling add() for each entry in order, but storage
+ * and indexes are grown only once.
+ * Return the positions in entries of the contacts which were not added: empty names, names
+ * already in the list and repeated names within entries, of which the first one is added.
+ * Throw an `std::length_error` before adding anything if the names do not fit into the list.
+ */
+std::vector<size_t> bulk_add(storage& contacts, std::span<const entry> entries);
+
+
+/**
+ * Add many contacts at once from any range of (name, number) pairs, see above.
+ * Entries made on the fly, e.g. by a transform view, are gone after their iteration,
+ * so their names are copied unless they are string_views already.
+ */
+template <std::ranges::input_range Range>
+    requires(!std::convertible_to<const Range&, std::span<const entry>>)
+std::vector<size_t> bulk_add(storage& contacts, const Range& entries) {
+    std::vector<entry> views;
+    std::string chars;
+    std::vector<size_t> ends;
+    if constexpr (std::ranges::sized_range<const Range>) {
+        views.reserve(std::ranges::size(entries));
+    }
+    for (auto&& [name, number] : entries) {
+        if constexpr (std::is_lvalue_reference_v<std::ranges::range_reference_t<const Range>>
+                      || std::same_as<std::remove_cvref_t<decltype(name)>, std::string_view>) {
+            views.emplace_back(name, number);
+        }
+        else {
+            // the views are taken after the loop, when chars does not move anymore
+            chars.append(name);
+            ends.push_back(chars.size());
+            views.emplace_back(std::string_view{}, number);
+        }
+    }
+    size_t begin = 0;
+    for (size_t i = 0; i < ends.size(); i++) {
+        views[i].first = std::string_view{chars}.substr(begin, ends[i] - begin);
+        begin = ends[i];
+    }
+    return bulk_add(contacts, std::span<const entry>{views});
+}
+
+
 /**
  * Given a contact storage, how many contacts are currently stored?
  */
@@ -59,22 +195,107 @@ number_t get_number_by_name(storage& contacts, std::string_view name);
 std::string to_string(const storage& contacts);
 
 
+/**
+ * Write a binary snapshot of the contact list to out, which has to be opened in binary mode.
+ * The snapshot uses the byte order of this machine.
+ */
+void save(const storage& contacts, std::ostream& out);
+
+
+/**
+ * Read a contact list from a binary snapshot written by save().
+ * Throw an `std::runtime_error` if the input is no valid snapshot.
+ */
+storage load(std::istream& in);
+
+
 /**
  * Remove a contact by name from the contact list.
+ * The others keep their order and no gap is left behind, like remove_mode::shift.
  */
 bool remove(storage& contacts, std::string_view name);
 
 
+/**
+ * how a contact is removed from the list.
+ * every mode also takes the numbers of the contact out of the number index, O(log n) each.
+ */
+enum class remove_mode {
+    shift,      // close the gap right away, O(n)
+    swap,       // move the last contact into the gap, O(log n) to update its numbers, but changes the order
+    tombstone,  // leave a gap and close all gaps in one pass later, amortized O(log n)
+};
+
+
+/**
+ * Remove a contact by name from the contact list, using the given mode.
+ */
+bool remove(storage& contacts, std::string_view name, remove_mode mode);
+
+
+/**
+ * Close the gaps left by removed contacts, keeping the order of the others,
+ * and drop the characters of removed names.
+ * This is done automatically once more than half of the slots or name characters are unused.
+ */
+void compact(storage& contacts);
+
+
 /**
  * Sort the contact list in-place by name.
  */
 void sort(storage& contacts);
 
 
+/**
+ * how the work of sorting the contact list is distributed.
+ */
+enum class sort_mode {
+    sequential,
+    parallel,  // on all hardware threads, worth it for large lists
+};
+
+
+/**
+ * Sort the contact list in-place by name, using the given mode.
+ */
+void sort(storage& contacts, sort_mode mode);
+
+
 /**
  * Fetch a contact name from storage given a number.
  */
 std::string get_name_by_number(storage& contacts, number_t number);
 
 
+/**
+ * Give an existing contact one more number.
+ * Return false if there is no contact with this name or it has this number already.
+ */
+bool add_number(storage& contacts, std::string_view name, number_t number);
+
+
+/**
+ * Remove one of the numbers of a contact. If it was the first one, the next one takes its place.
+ * Return false if there is no contact with this name, it does not have this number
+ * or it is the only number of the contact.
+ */
+bool remove_number(storage& contacts, std::string_view name, number_t number);
+
+
+/**
+ * Fetch all numbers of a contact, the first one is the one get_number_by_name() returns.
+ * The result is empty if there is no contact with this name.
+ */
+std::vector<number_t> get_numbers_by_name(storage& contacts, std::string_view name);
+
+
+/**
+ * Fetch the numbers in the range [first, last) with the names of their contacts, ordered by number.
+ * An area code is a range, e.g. [4930'0000'0000, 4931'0000'0000) holds the 12 digit numbers starting with 4930.
+ * Takes O(log n + k) for k numbers in the range.
+ */
+std::vector<std::pair<number_t, std::string>> get_names_by_number_range(storage& contacts, number_t first, number_t last);
+
+
 } // namespace contact_list
@@ -1,3 +1,5 @@
 #pragma once
 
+#include "concurrent_contact_list.h"
 #include "contact_list.h"
+#include "name_search.h"
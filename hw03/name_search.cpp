@@ -0,0 +1,270 @@
+#include "name_search.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace contact_list{
+namespace {
+
+/**
+ * The distinct trigrams of a name, padded like described for search_index::trigrams, sorted.
+ * Each trigram is packed into the lower three bytes of a number.
+ */
+std::vector<uint32_t> trigrams_of(std::string_view name){
+    std::vector<uint32_t> out;
+    out.reserve(name.size() + 1);
+    uint32_t window = 0;
+    for(char c : name){
+        window = ((window << 8) | static_cast<unsigned char>(c)) & 0xffffff;
+        out.push_back(window);
+    }
+    out.push_back((window << 8) & 0xffffff);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+
+/**
+ * Levenshtein distance of a and b, or bound + 1 if it is larger than bound.
+ * row is scratch space, so repeated calls do not allocate.
+ */
+size_t edit_distance(std::string_view a, std::string_view b, size_t bound, std::vector<size_t>& row){
+    if(a.size() > b.size()){
+        std::swap(a, b);
+    }
+    if(b.size() - a.size() > bound){
+        return bound + 1;
+    }
+    // row[i] is the distance of the first i characters of a to the characters of b seen so far
+    row.resize(a.size() + 1);
+    std::iota(row.begin(), row.end(), size_t{0});
+    for(size_t j=1; j<=b.size(); j++){
+        size_t diagonal = row[0];
+        row[0] = j;
+        size_t row_min = row[0];
+        for(size_t i=1; i<=a.size(); i++){
+            size_t above = row[i];
+            row[i] = std::min({row[i] + 1, row[i-1] + 1, diagonal + (a[i-1] != b[j-1])});
+            diagonal = above;
+            row_min = std::min(row_min, row[i]);
+        }
+        // distances never shrink from one row to the next
+        if(row_min > bound){
+            return bound + 1;
+        }
+    }
+    return std::min(row[a.size()], bound + 1);
+}
+
+
+/**
+ * Levenshtein distance to a fixed pattern of at most 64 characters, computed with
+ * the bit-parallel algorithm of Myers: one column of the distance matrix is kept as
+ * bit vectors of +1 / -1 steps, so each character of the text costs a few word operations.
+ */
+class pattern_distance {
+public:
+    explicit pattern_distance(std::string_view pattern) : _length{pattern.size()} {
+        for(size_t i=0; i<pattern.size(); i++){
+            _match[static_cast<unsigned char>(pattern[i])] |= uint64_t{1} << i;
+        }
+    }
+
+    size_t operator()(std::string_view text) const{
+        if(_length == 0){
+            return text.size();
+        }
+        uint64_t last = uint64_t{1} << (_length - 1);
+        uint64_t plus = ~uint64_t{0};
+        uint64_t minus = 0;
+        size_t distance = _length;
+        for(char c : text){
+            uint64_t eq = _match[static_cast<unsigned char>(c)];
+            uint64_t xv = eq | minus;
+            uint64_t xh = (((eq & plus) + plus) ^ plus) | eq;
+            uint64_t hplus = minus | ~(xh | plus);
+            uint64_t hminus = plus & xh;
+            if(hplus & last){
+                distance++;
+            }
+            else if(hminus & last){
+                distance--;
+            }
+            // the first row of the matrix grows by one per character
+            hplus = (hplus << 1) | 1;
+            hminus <<= 1;
+            plus = hminus | ~(xv | hplus);
+            minus = hplus & xv;
+        }
+        return distance;
+    }
+
+private:
+    size_t _length;
+    uint64_t _match[256] = {};
+};
+
+
+/**
+ * The slots of an index built before the last change of the storage may be gone or hold other names.
+ */
+void check_up_to_date(const storage& contacts, const search_index& index){
+    if(index.generation != contacts.generation){
+        throw std::logic_error("search index is out of date, build it again");
+    }
+}
+} // namespace
+
+
+/**
+ * Build the search index for all contacts in the storage.
+ */
+search_index build_search_index(const storage& contacts){
+    search_index index;
+    index.generation = contacts.generation;
+    size_t names_size = contacts.names.size();
+
+    for(size_t i=0; i<names_size; i++){
+        if(contacts.names[i].length != 0){
+            index.by_name.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(index.by_name.begin(), index.by_name.end(),
+              [&contacts](uint32_t a, uint32_t b){return name_at(contacts, a) < name_at(contacts, b);});
+
+    // collect (trigram, slot) pairs, sorting them groups the slots by trigram
+    std::vector<uint64_t> pairs;
+    pairs.reserve(contacts.name_chars.size() + index.by_name.size());
+    for(uint32_t slot : index.by_name){
+        for(uint32_t trigram : trigrams_of(name_at(contacts, slot))){
+            pairs.push_back((uint64_t{trigram} << 32) | slot);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    index.trigram_slots.reserve(pairs.size());
+    for(uint64_t pair : pairs){
+        auto trigram = static_cast<uint32_t>(pair >> 32);
+        if(index.trigrams.empty() || index.trigrams.back() != trigram){
+            index.trigrams.push_back(trigram);
+            index.trigram_begin.push_back(static_cast<uint32_t>(index.trigram_slots.size()));
+        }
+        index.trigram_slots.push_back(static_cast<uint32_t>(pair));
+    }
+    index.trigram_begin.push_back(static_cast<uint32_t>(index.trigram_slots.size()));
+    return index;
+}
+
+
+/**
+ * Find the names starting with prefix, in alphabetical order.
+ */
+std::vector<std::string> find_by_prefix(const storage& contacts, const search_index& index,
+                                        std::string_view prefix, size_t limit){
+    check_up_to_date(contacts, index);
+    auto it = std::lower_bound(index.by_name.begin(), index.by_name.end(), prefix,
+                               [&contacts](uint32_t slot, std::string_view p){return name_at(contacts, slot) < p;});
+    std::vector<std::string> found;
+    for(; it != index.by_name.end() && found.size() < limit; ++it){
+        std::string_view name = name_at(contacts, *it);
+        if(!name.starts_with(prefix)){
+            break;
+        }
+        found.emplace_back(name);
+    }
+    return found;
+}
+
+
+/**
+ * Find the names within max_distance edits of name, closest first.
+ */
+std::vector<std::string> find_similar(const storage& contacts, const search_index& index,
+                                      std::string_view name, size_t max_distance, size_t limit){
+    check_up_to_date(contacts, index);
+    std::vector<std::pair<size_t, uint32_t>> matches;
+    std::vector<size_t> row;
+    pattern_distance distance_to_name{name.substr(0, 64)};
+    auto check = [&](uint32_t slot){
+        std::string_view candidate = name_at(contacts, slot);
+        size_t length_difference = candidate.size() > name.size() ? candidate.size() - name.size() : name.size() - candidate.size();
+        if(length_difference > max_distance){
+            return;
+        }
+        size_t distance = name.size() <= 64 ? distance_to_name(candidate) : edit_distance(candidate, name, max_distance, row);
+        if(distance <= max_distance){
+            matches.emplace_back(distance, slot);
+        }
+    };
+
+    // every edit changes at most three trigrams, so a match shares all but lost = 3 * max_distance
+    // trigrams of name. of any L trigram lists it is therefore in at least L - lost, which
+    // only few names are, if the lists are long enough.
+    // the lists a name is in are counted in a hit_count, so at most max_lists lists are used.
+    using hit_count = uint16_t;
+    constexpr size_t max_lists = std::numeric_limits<hit_count>::max();
+    std::vector<uint32_t> query = trigrams_of(name);
+    size_t lost = max_distance < max_lists ? 3 * max_distance : max_lists;
+    if(query.size() > lost && lost < max_lists){
+        std::vector<std::pair<uint32_t, uint32_t>> postings;
+        for(uint32_t trigram : query){
+            auto it = std::lower_bound(index.trigrams.begin(), index.trigrams.end(), trigram);
+            if(it == index.trigrams.end() || *it != trigram){
+                postings.emplace_back(0, 0);
+                continue;
+            }
+            size_t i = static_cast<size_t>(it - index.trigrams.begin());
+            postings.emplace_back(index.trigram_begin[i], index.trigram_begin[i+1]);
+        }
+        std::sort(postings.begin(), postings.end(),
+                  [](auto a, auto b){return a.second - a.first < b.second - b.first;});
+
+        // the lost + 1 rarest lists are needed, further lists are used as long as
+        // they do not cost much more to read than those
+        size_t used = lost + 1;
+        size_t needed_cost = 0;
+        for(size_t i=0; i<used; i++){
+            needed_cost += postings[i].second - postings[i].first;
+        }
+        size_t cost = needed_cost;
+        while(used < postings.size() && used < max_lists
+              && cost + postings[used].second - postings[used].first <= 8 * needed_cost + 1024){
+            cost += postings[used].second - postings[used].first;
+            used++;
+        }
+
+        // count in how many lists each name is, it is checked when reaching the minimum
+        auto required = static_cast<hit_count>(used - lost);
+        std::vector<hit_count> hits(contacts.names.size());
+        for(size_t l=0; l<used; l++){
+            for(uint32_t i=postings[l].first; i<postings[l].second; i++){
+                uint32_t slot = index.trigram_slots[i];
+                if(++hits[slot] == required){
+                    check(slot);
+                }
+            }
+        }
+    }
+    else{
+        // too short or too far off to filter anything, check all names
+        for(uint32_t slot : index.by_name){
+            check(slot);
+        }
+    }
+
+    auto closer = [&contacts](const auto& a, const auto& b){
+        return a.first != b.first ? a.first < b.first : name_at(contacts, a.second) < name_at(contacts, b.second);
+    };
+    size_t count = std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(count), matches.end(), closer);
+
+    std::vector<std::string> found;
+    for(size_t i=0; i<count; i++){
+        found.emplace_back(name_at(contacts, matches[i].second));
+    }
+    return found;
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "contact_list.h"
+
+
+namespace contact_list {
+
+
+/**
+ * index for searching contact names by prefix and by similarity.
+ *
+ * it is built from a storage and refers to its slots, so it has to be built again
+ * after contacts were added, removed or the list was sorted or compacted.
+ * the searches check this and throw an `std::logic_error` for an index which is out of date.
+ */
+struct search_index {
+    /**
+     * slots of all contacts, ordered by name, for binary searching a prefix.
+     */
+    std::vector<uint32_t> by_name;
+
+    /**
+     * all trigrams (three consecutive characters) occurring in the names, sorted.
+     * names are padded with two '\0' in front and one behind, so short names have trigrams too.
+     */
+    std::vector<uint32_t> trigrams;
+
+    /**
+     * the slots of the names containing trigrams[i] are
+     * trigram_slots[trigram_begin[i]] up to trigram_slots[trigram_begin[i + 1]].
+     */
+    std::vector<uint32_t> trigram_begin;
+    std::vector<uint32_t> trigram_slots;
+
+    /**
+     * storage::generation of the storage the index was built from.
+     */
+    uint64_t generation = 0;
+};
+
+
+/**
+ * Build the search index for all contacts in the storage.
+ */
+search_index build_search_index(const storage& contacts);
+
+
+/**
+ * Find the names starting with prefix, in alphabetical order.
+ * At most limit names are returned.
+ * Throw an `std::logic_error` if the index was built before the last change of the storage.
+ */
+std::vector<std::string> find_by_prefix(const storage& contacts, const search_index& index,
+                                        std::string_view prefix, size_t limit);
+
+
+/**
+ * Find the names which can be turned into name with at most max_distance insertions,
+ * deletions or substitutions of single characters.
+ * The closest names come first, names with the same distance are in alphabetical order.
+ * At most limit names are returned.
+ * Throw an `std::logic_error` if the index was built before the last change of the storage.
+ */
+std::vector<std::string> find_similar(const storage& contacts, const search_index& index,
+                                      std::string_view name, size_t max_distance, size_t limit);
+
+
+} // namespace contact_list
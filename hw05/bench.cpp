@@ -0,0 +1,136 @@
+#include "hw05.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput of the SQL tokenizer and validator.
+ *
+ * usage: sql_bench [queries]
+ *
+ * The given number of queries (default 10^6) is generated, with one to eight columns or `*`,
+ * names of one to twenty characters and random whitespace. Every fourth query is broken by
+ * dropping or repeating one of its tokens. Then the queries are tokenized, validated as text,
+ * which tokenizes them again, and validated from the tokens of the first pass.
+ *
+ * Configure with -DCMAKE_BUILD_TYPE=Release, debug numbers are meaningless.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Results must go somewhere, otherwise the compiler removes the work
+volatile size_t sink;
+
+/// Run `f` once and print the time per query, per token and the amount of text read per second
+template <typename F> void report(const std::string &name, size_t queries, size_t tokens, size_t bytes, F f) {
+  auto start = clock_type::now();
+  f();
+  auto stop = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(12) << ns / static_cast<double>(queries) << " ns/query" << std::setw(10)
+            << ns / static_cast<double>(tokens) << " ns/token" << std::setw(10)
+            << static_cast<double>(bytes) / ns * 1e3 << " MB/s\n";
+}
+
+std::vector<std::string> make_queries(size_t count) {
+  std::mt19937_64 rng{42};
+  auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+  const std::string name_chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+  const std::vector<std::string> spaces{" ", " ", " ", "  ", "\n", "\t", "\n    "};
+
+  std::vector<std::string> queries;
+  queries.reserve(count);
+  for (size_t q = 0; q < count; q++) {
+    auto name = [&] {
+      // names do not start with a digit, so they are never mistaken for numbers
+      std::string n(1, name_chars[pick(52)]);
+      for (size_t i = pick(20); i > 0; i--) {
+        n += name_chars[pick(name_chars.size())];
+      }
+      return n;
+    };
+    std::vector<std::string> words{pick(2) == 0 ? "SELECT" : "select"};
+    if (pick(4) == 0) {
+      words.emplace_back("*");
+    } else {
+      for (size_t c = pick(8) + 1; c > 0; c--) {
+        words.push_back(name());
+        if (c > 1) {
+          words.emplace_back(",");
+        }
+      }
+    }
+    words.emplace_back("FROM");
+    words.push_back(name());
+    words.emplace_back(";");
+    if (q % 4 == 3) {
+      size_t broken = pick(words.size());
+      if (pick(2) == 0) {
+        words.erase(words.begin() + static_cast<std::ptrdiff_t>(broken));
+      } else {
+        words.insert(words.begin() + static_cast<std::ptrdiff_t>(broken), words[broken]);
+      }
+    }
+
+    std::string query;
+    for (const auto &word : words) {
+      query += word;
+      query += spaces[pick(spaces.size())];
+    }
+    queries.push_back(std::move(query));
+  }
+  return queries;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::vector<std::string> queries = make_queries(count);
+  size_t bytes = 0;
+  for (const auto &query : queries) {
+    bytes += query.size();
+  }
+  std::vector<std::vector<sql::Token>> tokenized;
+  tokenized.reserve(count);
+  size_t tokens = 0;
+  for (const auto &query : queries) {
+    tokenized.push_back(sql::tokenize(query));
+    tokens += tokenized.back().size();
+  }
+  std::cout << count << " queries, " << tokens << " tokens, " << bytes << " bytes\n";
+
+  report("tokenize", count, tokens, bytes, [&] {
+    size_t read = 0;
+    for (const auto &query : queries) {
+      sql::Tokenizer tokenizer{query};
+      while (tokenizer.next()) {
+        read++;
+      }
+    }
+    sink = read;
+  });
+  report("validate text", count, tokens, bytes, [&] {
+    size_t valid = 0;
+    for (const auto &query : queries) {
+      valid += sql::is_valid_sql_query(std::string_view{query});
+    }
+    sink = valid;
+  });
+  report("validate tokens", count, tokens, bytes, [&] {
+    size_t valid = 0;
+    for (const auto &query_tokens : tokenized) {
+      valid += sql::is_valid_sql_query(query_tokens);
+    }
+    sink = valid;
+  });
+  return 0;
+}
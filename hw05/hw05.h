@@ -1,4 +1,5 @@
 #pragma once
 
 #include "token.h"
+#include "tokenizer.h"
 #include "validator.h"
@@ -1,7 +1,9 @@
 #include "token.h"
 
+#include <utility>
+
 namespace sql {
-Token::Token(token_type value) : value_(value) {}
+Token::Token(token_type value) : value_(std::move(value)) {}
 
-Token::token_type Token::value() const { return value_; }
+const Token::token_type &Token::value() const { return value_; }
 }
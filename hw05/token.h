@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace sql {
@@ -9,26 +11,39 @@ namespace token {
 /// Each token is represented by a struct, this is the bases of our type based token system
 struct Select {};
 
+/// The text of a token. It is a view into the query the token was read from, so tokenizing does not
+/// copy any characters, and the query has to outlive the token.
+/// A view of a temporary `std::string` would dangle right away, so constructing from one does not
+/// compile, while string literals, views and named strings are fine.
+struct Text {
+  std::string_view name;
+
+  constexpr Text() = default;
+  constexpr Text(std::string_view name) : name(name) {}
+  constexpr Text(const char *name) : name(name) {}
+  Text(std::string &&) = delete;
+};
+
 /// Token can also carry some information, but this is more to show of the possibilities, we are not
-/// using it here
-struct Identifier {
-  std::string name;
+/// using it here.
+struct Identifier : Text {
+  using Text::Text;
 };
 
-struct From {
-  std::string name;
+struct From : Text {
+  using Text::Text;
 };
 
-struct Comma {
-  std::string name;
+struct Comma : Text {
+  using Text::Text;
 };
 
-struct Asterisks {
-  std::string name;
+struct Asterisks : Text {
+  using Text::Text;
 };
 
-struct Semicolon {
-  std::string name;
+struct Semicolon : Text {
+  using Text::Text;
 };
 } // namespace token
 
@@ -44,12 +59,17 @@ public:
   // token? Maybe Unknown, but we don't have that so just disallow it
   Token() = delete;
 
-  // Construct a token from a variant
+  // Construct a token from a variant. The text of the token is not copied, see `token::Text`, so
+  // whatever the token was read from has to outlive it
   Token(token_type value);
 
   /// Getter for the underlying variant
   [[nodiscard]]
-  token_type value() const;
+  const token_type &value() const;
+
+  /// Index of the type of the token in `token_type`
+  [[nodiscard]]
+  size_t kind() const { return value_.index(); }
 
 private:
   token_type value_;
@@ -0,0 +1,151 @@
+#include "tokenizer.h"
+
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sql {
+
+namespace {
+bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+bool is_word(char c) {
+  return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '_';
+}
+
+#if defined(__SSE2__)
+/// Bytes of c between lo and hi, as 0xff, all others 0
+__m128i in_range(__m128i c, char lo, char hi) {
+  __m128i above_lo = _mm_cmpeq_epi8(_mm_max_epu8(c, _mm_set1_epi8(lo)), c);
+  __m128i below_hi = _mm_cmpeq_epi8(_mm_min_epu8(c, _mm_set1_epi8(hi)), c);
+  return _mm_and_si128(above_lo, below_hi);
+}
+
+/// Bit i is set if character i of the 16 at text is whitespace
+unsigned space_mask(const char *text) {
+  __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+  __m128i space = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), in_range(c, '\t', '\r'));
+  return static_cast<unsigned>(_mm_movemask_epi8(space));
+}
+
+/// Bit i is set if character i of the 16 at text can be part of a word
+unsigned word_mask(const char *text) {
+  __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+  __m128i letter = in_range(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z');
+  __m128i digit = in_range(c, '0', '9');
+  __m128i underscore = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore)));
+}
+
+/// Offset of the first block of 16 characters from position on in which `mask` does not set all
+/// bits, or of the last characters which do not fill a block
+template <typename Mask>
+size_t skip_blocks(std::string_view text, size_t position, Mask mask) {
+  while (position + 16 <= text.size()) {
+    unsigned others = ~mask(text.data() + position) & 0xffff;
+    if (others != 0) {
+      return position + static_cast<size_t>(std::countr_zero(others));
+    }
+    position += 16;
+  }
+  return position;
+}
+#endif
+
+/// Offset of the first character from position on which is no whitespace
+size_t skip_space(std::string_view text, size_t position) {
+#if defined(__SSE2__)
+  position = skip_blocks(text, position, space_mask);
+#endif
+  while (position < text.size() && is_space(text[position])) {
+    position++;
+  }
+  return position;
+}
+
+/// Offset of the first character from position on which can not be part of a word
+size_t skip_word(std::string_view text, size_t position) {
+#if defined(__SSE2__)
+  position = skip_blocks(text, position, word_mask);
+#endif
+  while (position < text.size() && is_word(text[position])) {
+    position++;
+  }
+  return position;
+}
+
+/// Compares a word with an upper case keyword, ignoring the case of the word
+bool is_keyword(std::string_view word, std::string_view keyword) {
+  if (word.size() != keyword.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < word.size(); i++) {
+    if ((word[i] & ~0x20) != keyword[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+Tokenizer::Tokenizer(std::string_view query) : query_(query) {}
+
+std::optional<Token> Tokenizer::next() {
+  if (failed_) {
+    return std::nullopt;
+  }
+  position_ = skip_space(query_, position_);
+  if (position_ == query_.size()) {
+    return std::nullopt;
+  }
+
+  size_t begin = position_;
+  switch (query_[begin]) {
+  case ',':
+    position_++;
+    return Token{token::Comma{query_.substr(begin, 1)}};
+  case '*':
+    position_++;
+    return Token{token::Asterisks{query_.substr(begin, 1)}};
+  case ';':
+    position_++;
+    return Token{token::Semicolon{query_.substr(begin, 1)}};
+  default:
+    break;
+  }
+
+  position_ = skip_word(query_, begin);
+  if (position_ == begin) {
+    failed_ = true;
+    return std::nullopt;
+  }
+  std::string_view word = query_.substr(begin, position_ - begin);
+  if (is_keyword(word, "SELECT")) {
+    return Token{token::Select{}};
+  }
+  if (is_keyword(word, "FROM")) {
+    return Token{token::From{word}};
+  }
+  return Token{token::Identifier{word}};
+}
+
+bool Tokenizer::failed() const { return failed_; }
+
+size_t Tokenizer::position() const { return position_; }
+
+std::vector<Token> tokenize(std::string_view query) {
+  std::vector<Token> tokens;
+  Tokenizer tokenizer{query};
+  while (auto token = tokenizer.next()) {
+    tokens.push_back(*token);
+  }
+  if (tokenizer.failed()) {
+    throw std::invalid_argument("unexpected character at position " + std::to_string(tokenizer.position()));
+  }
+  return tokens;
+}
+} // namespace sql
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "token.h"
+
+namespace sql {
+
+/// Splits the text of a query into tokens, one at a time.
+///
+/// `SELECT` and `FROM` are keywords in any case, `,`, `*` and `;` stand for themselves and any
+/// other run of letters, digits and `_` is an identifier. Tokens are separated by whitespace or
+/// by the single character tokens. The names of the tokens are views into the query, so nothing
+/// is copied, but the query has to outlive the tokens.
+class Tokenizer {
+public:
+  explicit Tokenizer(std::string_view query);
+
+  /// Returns the next token, or `std::nullopt` at the end of the query or at a character no
+  /// token can contain. `failed()` tells the two apart.
+  [[nodiscard]]
+  std::optional<Token> next();
+
+  /// Returns `true` if the tokenizer stopped at a character no token can contain
+  [[nodiscard]]
+  bool failed() const;
+
+  /// Offset of the first character of the query which was not read yet, or of the one the
+  /// tokenizer failed at
+  [[nodiscard]]
+  size_t position() const;
+
+private:
+  std::string_view query_;
+  size_t position_ = 0;
+  bool failed_ = false;
+};
+
+/// Splits the whole query into tokens.
+/// Throws `std::invalid_argument` if the query contains a character no token can contain.
+[[nodiscard]]
+std::vector<Token> tokenize(std::string_view query);
+} // namespace sql
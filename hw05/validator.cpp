@@ -1,196 +1,110 @@
 #include "validator.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "token.h"
+#include "tokenizer.h"
 
 namespace sql {
 
-bool SqlValidator::is_valid() const {
-  /// TODO: Implement this
-  return std::holds_alternative<sql::state::Valid>(state_);
+namespace {
+constexpr size_t state_count = std::variant_size_v<State>;
+constexpr size_t token_kind_count = std::variant_size_v<Token::token_type>;
+
+/// Index of a state in `State`
+template <class S> constexpr auto state_index = static_cast<std::uint8_t>(State{S{}}.index());
+
+/// Index of a token type in `Token::token_type`, the same as `Token::kind()`
+template <class T> constexpr size_t token_kind = Token::token_type{T{}}.index();
+
+/// The state following each state for each kind of token, by their indices
+using TransitionTable = std::array<std::array<std::uint8_t, token_kind_count>, state_count>;
+
+template <class From, class T, class To> constexpr void add_transition(TransitionTable &table) {
+  table[state_index<From>][token_kind<T>] = state_index<To>;
 }
 
-void SqlValidator::handle(Token token) {
-  /// TODO: Implement this
-  int ind = state_.index();
-  if (ind == 0){
-      auto new_state = state::Start{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 1){
-      auto new_state = state::Invalid{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 2){
-      auto new_state = state::Valid{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 3) { 
-      auto new_state = state::SelectStmt{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 4) {
-      auto new_state = state::AllColumns{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 5) {
-      auto new_state = state::NamedColumn{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 6) {
-      auto new_state = state::MoreColumns{};
-      state_ = transition(new_state, token);  
-  } else if (ind == 7) {
-      auto new_state = state::FromClause{};
-      state_ = transition(new_state, token);  
-  } else {
-      auto new_state = state::TableName{};
-      state_ = transition(new_state, token);  
-  }}
-
-bool is_valid_sql_query(std::vector<Token> tokens) {
-  sql::SqlValidator validator{};
-  for (auto& token:tokens) {
-    validator.handle(token);
+/// The FSM, compiled into a table. Every transition not listed here leads to the `Invalid`
+/// state, which is never left.
+constexpr TransitionTable make_transition_table() {
+  TransitionTable table{};
+  for (auto &row : table) {
+    row.fill(state_index<state::Invalid>);
   }
-  return validator.is_valid();
+  add_transition<state::Start, token::Select, state::SelectStmt>(table);
+  add_transition<state::SelectStmt, token::Asterisks, state::AllColumns>(table);
+  add_transition<state::SelectStmt, token::Identifier, state::NamedColumn>(table);
+  add_transition<state::AllColumns, token::From, state::FromClause>(table);
+  add_transition<state::NamedColumn, token::Comma, state::MoreColumns>(table);
+  add_transition<state::NamedColumn, token::From, state::FromClause>(table);
+  add_transition<state::MoreColumns, token::Identifier, state::NamedColumn>(table);
+  add_transition<state::FromClause, token::Identifier, state::TableName>(table);
+  add_transition<state::TableName, token::Semicolon, state::Valid>(table);
+  // only the semicolon is allowed after a valid query
+  add_transition<state::Valid, token::Semicolon, state::Valid>(table);
+  return table;
 }
 
+constexpr TransitionTable transitions = make_transition_table();
 
-struct TransitionFromStartVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Select) const { return state::SelectStmt{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-  State operator()(token::Identifier) const { return state::Invalid{}; }
-};
-
-struct TransitionFromValidVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Semicolon) const { return state::Valid{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Identifier) const { return state::Invalid{}; }
-};
-
-struct TransitionFromSelectStmtVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Asterisks) const { return state::AllColumns{}; }
-  State operator()(token::Identifier) const { return state::NamedColumn{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-};
-
-struct TransitionFromAllColumnsVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::From) const { return state::FromClause{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-  State operator()(token::Identifier) const { return state::Invalid{}; }
-};
-
-struct TransitionFromNamedColumnVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Comma) const { return state::MoreColumns{}; }
-  State operator()(token::From) const { return state::FromClause{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::Identifier) const { return state::Invalid{}; }
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-};
-
-struct TransitionFromMoreColumnsVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Identifier) const { return state::NamedColumn{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-};
-
-struct TransitionFromFromClauseVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Identifier) const { return state::TableName{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Semicolon) const { return state::Invalid{}; }
-};
-
-struct TransitionFromTableNameVisitor {
-  /// Only the `Select` token advances the FSM from the `Start` state
-  /// TODO: Correct the behaviour
-  State operator()(token::Semicolon) const { return state::Valid{}; }
-
-  /// All the other tokens, put it in the invalid state
-  State operator()(token::From) const { return state::Invalid{}; }
-  State operator()(token::Select) const { return state::Invalid{}; }
-  State operator()(token::Comma) const { return state::Invalid{}; }
-  State operator()(token::Asterisks) const { return state::Invalid{}; }
-  State operator()(token::Identifier) const { return state::Invalid{}; }
-};
-
-
-State transition(state::Start, Token token) {
-  return std::visit(TransitionFromStartVisitor{}, token.value());
-}
+static_assert(state_index<state::Start> == 0, "SqlValidator starts with state index 0");
+static_assert(transitions[state_index<state::TableName>][token_kind<token::Semicolon>] == state_index<state::Valid>);
 
-State transition(state::Valid, Token token) {
-  return std::visit(TransitionFromValidVisitor{}, token.value());
-}
+/// All states by their index in `State`
+constexpr auto all_states = []<size_t... I>(std::index_sequence<I...>) {
+  return std::array<State, state_count>{State{std::in_place_index<I>}...};
+}(std::make_index_sequence<state_count>{});
 
-State transition(state::Invalid, Token token) {
-  return state::Invalid{};
+template <class S> State table_transition(const Token &token) {
+  return all_states[transitions[state_index<S>][token.kind()]];
 }
+} // namespace
 
-State transition(state::SelectStmt, Token token) {
-  return std::visit(TransitionFromSelectStmtVisitor{}, token.value());
-}
-  
-State transition(state::AllColumns, Token token) {
-  return std::visit(TransitionFromAllColumnsVisitor{}, token.value());
+bool SqlValidator::is_valid() const {
+  return state_ == state_index<state::Valid>;
 }
 
-State transition(state::NamedColumn, Token token) {
-  return std::visit(TransitionFromNamedColumnVisitor{}, token.value());
+void SqlValidator::handle(const Token &token) {
+  state_ = transitions[state_][token.kind()];
 }
 
-State transition(state::MoreColumns, Token token) {
-  return std::visit(TransitionFromMoreColumnsVisitor{}, token.value());
+bool is_valid_sql_query(const std::vector<Token> &tokens) {
+  sql::SqlValidator validator{};
+  for (const auto &token : tokens) {
+    validator.handle(token);
+  }
+  return validator.is_valid();
 }
 
-State transition(state::FromClause, Token token) {
-  return std::visit(TransitionFromFromClauseVisitor{}, token.value());
+bool is_valid_sql_query(std::string_view query) {
+  sql::SqlValidator validator{};
+  Tokenizer tokenizer{query};
+  while (auto token = tokenizer.next()) {
+    validator.handle(*token);
+  }
+  return !tokenizer.failed() && validator.is_valid();
 }
 
-State transition(state::TableName, Token token) {
-  return std::visit(TransitionFromTableNameVisitor{}, token.value());
-}
+State transition(state::Start, const Token &token) { return table_transition<state::Start>(token); }
+
+State transition(state::Valid, const Token &token) { return table_transition<state::Valid>(token); }
+
+State transition(state::Invalid, const Token &token) { return table_transition<state::Invalid>(token); }
+
+State transition(state::SelectStmt, const Token &token) { return table_transition<state::SelectStmt>(token); }
+
+State transition(state::AllColumns, const Token &token) { return table_transition<state::AllColumns>(token); }
+
+State transition(state::NamedColumn, const Token &token) { return table_transition<state::NamedColumn>(token); }
+
+State transition(state::MoreColumns, const Token &token) { return table_transition<state::MoreColumns>(token); }
+
+State transition(state::FromClause, const Token &token) { return table_transition<state::FromClause>(token); }
+
+State transition(state::TableName, const Token &token) { return table_transition<state::TableName>(token); }
 } // namespace sql
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -39,17 +41,17 @@ using State =
 /// Transition from the `Start` state to the next state depending on the given
 /// token
 [[nodiscard]]
-State transition(state::Start, Token token);
+State transition(state::Start, const Token &token);
 
 /// Transition from the `Valid` state to the next state depending on the given
 /// token
 [[nodiscard]]
-State transition(state::Valid, Token token);
+State transition(state::Valid, const Token &token);
 
 /// Transition from the `Invalid` state to the next state depending on the given
 /// token
 [[nodiscard]]
-State transition(state::Invalid, Token token);
+State transition(state::Invalid, const Token &token);
 
 /*
  * TODO: all of the transition functions from the newly created states go
@@ -58,12 +60,12 @@ State transition(state::Invalid, Token token);
 /*
  * ... and here
  */
-State transition(state::SelectStmt, Token token);
-State transition(state::AllColumns, Token token);
-State transition(state::NamedColumn, Token token);
-State transition(state::MoreColumns, Token token);
-State transition(state::FromClause, Token token);
-State transition(state::TableName, Token token);
+State transition(state::SelectStmt, const Token &token);
+State transition(state::AllColumns, const Token &token);
+State transition(state::NamedColumn, const Token &token);
+State transition(state::MoreColumns, const Token &token);
+State transition(state::FromClause, const Token &token);
+State transition(state::TableName, const Token &token);
 
 
 /// Our finite state machine.
@@ -74,21 +76,18 @@ class SqlValidator {
 public:
   SqlValidator() = default;
 
-  /// TODO: Implement this member function
-  /// Returns `true` iff the variant is in the `Valid` state
+  /// Returns `true` iff the validator is in the `Valid` state
   [[nodiscard]]
   bool is_valid() const;
 
-  /// TODO: Implement this member function
   /// Moves from one state to the next given the token.
-  void handle(Token token);
+  void handle(const Token &token);
 
 private:
-  State state_ = state::Start{};
+  /// Index of the current state in `State`, so a transition is a single lookup in the transition table
+  std::uint8_t state_ = 0;
 };
 
-/// TODO: Implement this function!
-///
 /// Given a sequence of tokens, this functions returns true, if it is a valid
 /// (simplified) select clause of SQL
 ///
@@ -102,5 +101,11 @@ private:
 ///
 /// These sequences must be given in a `std::vector<Token>`
 [[nodiscard]]
-bool is_valid_sql_query(std::vector<Token> tokens);
+bool is_valid_sql_query(const std::vector<Token> &tokens);
+
+/// Given the text of a query, this function returns true, if it is a valid (simplified) select
+/// clause of SQL. The tokens are handed to the validator while the query is read, no sequence of
+/// tokens is built. A query with a character no token can contain is invalid.
+[[nodiscard]]
+bool is_valid_sql_query(std::string_view query);
 } // namespace sql
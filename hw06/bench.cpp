@@ -0,0 +1,391 @@
+#include "hw06.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/*
+ * Microbenchmarks for all public operations of linalg::Vector.
+ *
+ * usage: linalg_bench [options]
+ *   --min-size N         smallest vector size (default 16)
+ *   --max-size N         largest vector size (default 100000000)
+ *   --filter TEXT        only run operations whose name contains TEXT
+ *   --min-time SECONDS   minimal measuring time per operation (default 0.05)
+ *   --threads N          threads used by the similarity search (default 1)
+ *   --cpus 0,2,...       pin the benchmark to the given cores (linux only)
+ *   --save-baseline FILE store the results as JSON
+ *   --baseline FILE      compare the results against a stored JSON baseline
+ *   --tolerance FRACTION allowed slowdown against the baseline (default 0.1)
+ *
+ * The exit code is 1 if any operation regressed against the baseline and 2 for
+ * invalid options or baseline files which can not be read or written.
+ * Configure with -DCMAKE_BUILD_TYPE=Release, debug numbers are meaningless.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Inputs shared by all operations of one size. They are rebuilt for every
+/// size, so the memory of the previous size is released first.
+struct Inputs {
+  linalg::Vector x;
+  linalg::Vector y;
+  linalg::Vector out;
+  std::size_t threads;
+  /// sparse vector keeping every `sparse_stride`-th element of `y`, built by
+  /// the first operation needing it
+  std::optional<linalg::SparseVector> sparse;
+  /// rows of `x` in an index, built by the first operation needing it
+  std::optional<linalg::SimilarityIndex> index;
+};
+
+/// Distance of the nonzeros of the sparse inputs, one in 50 is a density of 2%
+constexpr std::size_t sparse_stride = 50;
+
+/// A benchmarked operation: its name, the bytes it reads and writes per
+/// element and the code to run once
+struct Operation {
+  std::string name;
+  double bytes_per_element;
+  std::function<void(Inputs &)> run;
+};
+
+/// Results must go somewhere, otherwise the compiler removes the work
+volatile float sink;
+
+void consume(float val) { sink = val; }
+
+void consume(std::size_t val) { sink = static_cast<float>(val); }
+
+void consume(const linalg::Vector &x) { sink = *x.begin(); }
+
+auto operations() -> std::vector<Operation> {
+  using namespace linalg;
+  return {
+      {"construct", 4, [](Inputs &in) { consume(Vector(in.x.size())); }},
+      {"construct_value", 4,
+       [](Inputs &in) { consume(Vector(in.x.size(), 1.f)); }},
+      {"copy", 8, [](Inputs &in) { in.out = in.x; }},
+      {"assign_value", 4, [](Inputs &in) { in.out.assign(0.5f); }},
+      {"operator=_value", 4, [](Inputs &in) { in.out = 0.5f; }},
+      {"iterate", 4,
+       [](Inputs &in) {
+         float acc = 0;
+         for (float v : in.x) {
+           acc += v;
+         }
+         consume(acc);
+       }},
+      {"operator[]", 4,
+       [](Inputs &in) {
+         float acc = 0;
+         int n = static_cast<int>(in.x.size());
+         for (int i = 0; i < n; ++i) {
+           acc += in.x[i];
+         }
+         consume(acc);
+       }},
+      {"coeff", 4,
+       [](Inputs &in) {
+         float acc = 0;
+         int n = static_cast<int>(in.x.size());
+         for (int i = 0; i < n; ++i) {
+           acc += in.x.coeff(i);
+         }
+         consume(acc);
+       }},
+      {"+=_scalar", 8, [](Inputs &in) { in.out += 1.f; }},
+      {"-=_scalar", 8, [](Inputs &in) { in.out -= 1.f; }},
+      {"*=_scalar", 8, [](Inputs &in) { in.out *= 1.f; }},
+      {"/=_scalar", 8, [](Inputs &in) { in.out /= 1.f; }},
+      {"+=_vector", 12, [](Inputs &in) { in.out += in.y; }},
+      {"-=_vector", 12, [](Inputs &in) { in.out -= in.y; }},
+      {"min", 4, [](Inputs &in) { consume(min(in.x)); }},
+      {"max", 4, [](Inputs &in) { consume(max(in.x)); }},
+      {"argmin", 4, [](Inputs &in) { consume(argmin(in.x)); }},
+      {"argmax", 4, [](Inputs &in) { consume(argmax(in.x)); }},
+      {"non_zeros", 4, [](Inputs &in) { consume(non_zeros(in.x)); }},
+      {"sum", 4, [](Inputs &in) { consume(sum(in.x)); }},
+      {"prod", 4, [](Inputs &in) { consume(prod(in.x)); }},
+      {"dot", 8, [](Inputs &in) { consume(dot(in.x, in.y)); }},
+      {"norm", 4, [](Inputs &in) { consume(norm(in.x)); }},
+      {"normalize", 12, [](Inputs &in) { normalize(in.out); }},
+      {"normalized", 12, [](Inputs &in) { consume(normalized(in.x)); }},
+      {"floor", 8, [](Inputs &in) { consume(floor(in.x)); }},
+      {"ceil", 8, [](Inputs &in) { consume(ceil(in.x)); }},
+      {"unary+", 8, [](Inputs &in) { consume(+in.x); }},
+      {"unary-", 8, [](Inputs &in) { consume(-in.x); }},
+      {"x+y", 12, [](Inputs &in) { consume(in.x + in.y); }},
+      {"x-y", 12, [](Inputs &in) { consume(in.x - in.y); }},
+      {"x+s", 8, [](Inputs &in) { consume(in.x + 1.f); }},
+      {"x-s", 8, [](Inputs &in) { consume(in.x - 1.f); }},
+      {"x*s", 8, [](Inputs &in) { consume(in.x * 2.f); }},
+      {"x/s", 8, [](Inputs &in) { consume(in.x / 2.f); }},
+      {"s+x", 8, [](Inputs &in) { consume(1.f + in.x); }},
+      {"s-x", 8, [](Inputs &in) { consume(1.f - in.x); }},
+      {"s*x", 8, [](Inputs &in) { consume(2.f * in.x); }},
+      {"axpy", 12, [](Inputs &in) { axpy(2.f, in.x, in.out); }},
+      {"axpby", 12, [](Inputs &in) { axpby(2.f, in.x, 0.5f, in.out); }},
+      {"fma_into", 16,
+       [](Inputs &in) { fma_into(in.x, in.y, in.out); }},
+      {"scale_add", 12, [](Inputs &in) { scale_add(0.5f, in.x, in.out); }},
+      {"lerp", 12, [](Inputs &in) { lerp(in.y, 0.5f, in.out); }},
+      {"exp", 8, [](Inputs &in) { exp_inplace(in.out); }},
+      {"log", 8, [](Inputs &in) { log_inplace(in.out); }},
+      {"tanh", 8, [](Inputs &in) { tanh_inplace(in.out); }},
+      {"sqrt", 8, [](Inputs &in) { sqrt_inplace(in.out); }},
+      {"abs", 8, [](Inputs &in) { abs_inplace(in.out); }},
+      {"clamp", 8, [](Inputs &in) { clamp_inplace(in.out, 0.f, 1.f); }},
+      {"softmax", 16, [](Inputs &in) { softmax_inplace(in.out); }},
+      {"map", 8,
+       [](Inputs &in) { map_inplace(in.out, [](float v) { return v * v; }); }},
+      {"sparse_from_dense", 8,
+       [](Inputs &in) { consume(non_zeros(SparseVector(in.x))); }},
+      // reads an index, a value and an element of `x` per nonzero
+      {"sparse_dot_dense", 16. / sparse_stride,
+       [](Inputs &in) {
+         // the sparse vector is built once per size and then reused
+         if (!in.sparse) {
+           Vector thinned(in.y.size());
+           for (std::size_t i = 0; i < in.y.size(); i += sparse_stride) {
+             thinned[static_cast<int>(i)] = in.y[static_cast<int>(i)];
+           }
+           in.sparse.emplace(thinned);
+         }
+         consume(dot(*in.sparse, in.x));
+       }},
+      {"similarity_search", 4,
+       [](Inputs &in) {
+         constexpr std::size_t dim = 16;
+         if (!in.index) {
+           auto &index = in.index.emplace(dim);
+           index.reserve(in.x.size() / dim);
+           Vector row(dim);
+           for (std::size_t r = 0; r + dim <= in.x.size(); r += dim) {
+             std::copy_n(in.x.begin() + static_cast<std::ptrdiff_t>(r), dim,
+                         row.begin());
+             index.add(row);
+           }
+         }
+         Vector query(dim, 1.f);
+         consume(in.index->search(query, 10, in.threads).size());
+       }},
+  };
+}
+
+/// Run `op` repeatedly for at least `min_time` seconds and return the fastest
+/// single run in nanoseconds
+auto measure(const Operation &op, Inputs &in, double min_time) -> double {
+  double best = 0;
+  double total = 0;
+  std::size_t runs = 0;
+  while (runs < 3 || total < min_time) {
+    in.out = in.x;
+    auto start = clock_type::now();
+    op.run(in);
+    auto stop = clock_type::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    best = runs == 0 ? ns : std::min(best, ns);
+    total += ns * 1e-9;
+    ++runs;
+  }
+  return best;
+}
+
+auto sizes(std::size_t min_size, std::size_t max_size)
+    -> std::vector<std::size_t> {
+  std::vector<std::size_t> out;
+  for (std::size_t n = min_size; n < max_size; n *= 16) {
+    out.push_back(n);
+  }
+  out.push_back(max_size);
+  return out;
+}
+
+auto load_baseline(const std::string &filename)
+    -> std::map<std::string, double> {
+  std::ifstream file{filename};
+  if (!file.is_open()) {
+    throw std::runtime_error("baseline could not be opened: " + filename);
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+  std::string text = content.str();
+
+  std::map<std::string, double> out;
+  std::regex entry{R"re("([^"]+)"\s*:\s*([-+0-9.eE]+))re"};
+  for (auto it = std::sregex_iterator(text.begin(), text.end(), entry);
+       it != std::sregex_iterator(); ++it) {
+    out[(*it)[1].str()] = std::stod((*it)[2].str());
+  }
+  return out;
+}
+
+auto save_baseline(const std::string &filename,
+                   const std::map<std::string, double> &results) -> void {
+  std::ofstream file{filename};
+  if (!file.is_open()) {
+    throw std::runtime_error("baseline could not be written: " + filename);
+  }
+  file << "{\n";
+  std::size_t i = 0;
+  for (const auto &[key, ns] : results) {
+    file << "  \"" << key << "\": " << std::setprecision(6) << ns
+         << (++i < results.size() ? ",\n" : "\n");
+  }
+  file << "}\n";
+}
+
+auto pin_to_cpus(const std::string &list) -> void {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  std::stringstream ss{list};
+  std::string cpu;
+  while (std::getline(ss, cpu, ',')) {
+    CPU_SET(std::stoi(cpu), &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    throw std::runtime_error("could not pin to cpus " + list);
+  }
+#else
+  std::cerr << "pinning to cpus is only supported on linux, ignoring --cpus "
+            << list << "\n";
+#endif
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t min_size = 16;
+  std::size_t max_size = 100'000'000;
+  std::string filter;
+  double min_time = 0.05;
+  std::size_t threads = 1;
+  std::string save_file;
+  std::string baseline_file;
+  double tolerance = 0.1;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    if (i + 1 >= args.size()) {
+      std::cerr << "missing value for " << args[i] << "\n";
+      return 2;
+    }
+    const auto &arg = args[i];
+    const auto &val = args[++i];
+    if (arg == "--min-size") {
+      min_size = std::stoull(val);
+    } else if (arg == "--max-size") {
+      max_size = std::stoull(val);
+    } else if (arg == "--filter") {
+      filter = val;
+    } else if (arg == "--min-time") {
+      min_time = std::stod(val);
+    } else if (arg == "--threads") {
+      threads = std::stoull(val);
+    } else if (arg == "--cpus") {
+      try {
+        pin_to_cpus(val);
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 2;
+      }
+    } else if (arg == "--save-baseline") {
+      save_file = val;
+    } else if (arg == "--baseline") {
+      baseline_file = val;
+    } else if (arg == "--tolerance") {
+      tolerance = std::stod(val);
+    } else {
+      std::cerr << "unknown option " << arg << "\n";
+      return 2;
+    }
+  }
+  if (min_size == 0 || max_size < min_size || threads == 0) {
+    std::cerr << "invalid sizes or thread count\n";
+    return 2;
+  }
+
+  std::map<std::string, double> baseline;
+  if (!baseline_file.empty()) {
+    try {
+      baseline = load_baseline(baseline_file);
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << "\n";
+      return 2;
+    }
+  }
+
+  std::map<std::string, double> results;
+  bool regressed = false;
+  std::cout << std::left << std::setw(20) << "operation" << std::right
+            << std::setw(12) << "size" << std::setw(12) << "ns/elem"
+            << std::setw(10) << "GB/s" << std::setw(12) << "baseline"
+            << "\n";
+
+  auto ops = operations();
+  for (auto n : sizes(min_size, max_size)) {
+    Inputs in{linalg::Vector(n), linalg::Vector(n), linalg::Vector(n), threads,
+              std::nullopt, std::nullopt};
+    // values close to one, so prod and the like neither under- nor overflow
+    std::size_t i = 0;
+    for (auto &v : in.x) {
+      v = 1.f + static_cast<float>(i++ % 7) * 1e-7f;
+    }
+    in.y = in.x;
+    in.y *= 0.5f;
+
+    for (const auto &op : ops) {
+      if (op.name.find(filter) == std::string::npos) {
+        continue;
+      }
+      double ns = measure(op, in, min_time);
+      double per_element = ns / static_cast<double>(n);
+      double gbs = op.bytes_per_element * static_cast<double>(n) / ns;
+      std::string key = op.name + "/" + std::to_string(n);
+      results[key] = per_element;
+
+      std::cout << std::left << std::setw(20) << op.name << std::right
+                << std::setw(12) << n << std::fixed << std::setprecision(4)
+                << std::setw(12) << per_element << std::setprecision(2)
+                << std::setw(10) << gbs;
+      if (auto it = baseline.find(key); it != baseline.end()) {
+        double change = per_element / it->second - 1.;
+        std::cout << std::showpos << std::setw(11) << change * 100. << "%"
+                  << std::noshowpos;
+        if (change > tolerance) {
+          std::cout << "  REGRESSION";
+          regressed = true;
+        }
+      }
+      std::cout << "\n";
+    }
+  }
+
+  if (!save_file.empty()) {
+    try {
+      save_baseline(save_file, results);
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << "\n";
+      return 2;
+    }
+  }
+  return regressed ? 1 : 0;
+}
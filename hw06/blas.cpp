@@ -0,0 +1,59 @@
+#include "blas.h"
+#include <stdexcept>
+
+// All loops run over raw pointers with a simple body, so the compiler turns
+// them into packed SIMD instructions.
+
+namespace linalg {
+
+void axpy(float a, const Vector &x, Vector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    const float *px = x.data();
+    float *py = y.data();
+    std::size_t n = y.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        py[i] = a * px[i] + py[i];
+    }
+}
+
+void axpby(float a, const Vector &x, float b, Vector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    const float *px = x.data();
+    float *py = y.data();
+    std::size_t n = y.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        py[i] = a * px[i] + b * py[i];
+    }
+}
+
+void fma_into(const Vector &x, const Vector &y, Vector &z) {
+    if (x.size() != z.size() || y.size() != z.size()) {throw std::invalid_argument("vectors have diff size");}
+    const float *px = x.data();
+    const float *py = y.data();
+    float *pz = z.data();
+    std::size_t n = z.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        pz[i] = px[i] * py[i] + pz[i];
+    }
+}
+
+void scale_add(float a, const Vector &x, Vector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    const float *px = x.data();
+    float *py = y.data();
+    std::size_t n = y.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        py[i] = a * py[i] + px[i];
+    }
+}
+
+void lerp(const Vector &x, float t, Vector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    const float *px = x.data();
+    float *py = y.data();
+    std::size_t n = y.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        py[i] = py[i] + t * (px[i] - py[i]);
+    }
+}
+}
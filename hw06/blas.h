@@ -0,0 +1,43 @@
+#include "vector.h"
+#pragma once
+
+namespace linalg {
+
+/* Fused update operations. Each of them modifies its last vector argument
+ * in-place in a single pass over memory, no temporary vectors are created. */
+
+/// Add a scaled vector, i.e. for each coefficient `y_i = a * x_i + y_i`
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto axpy(float a, const Vector &x, Vector &y) -> void;
+
+/// Add a scaled vector to a scaled vector, i.e. for each coefficient
+/// `y_i = a * x_i + b * y_i`
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto axpby(float a, const Vector &x, float b, Vector &y) -> void;
+
+/// Element-wise multiply-add into `z`, i.e. for each coefficient
+/// `z_i = x_i * y_i + z_i`. Named apart from `std::fma`, which it would
+/// otherwise shadow inside the namespace.
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto fma_into(const Vector &x, const Vector &y, Vector &z) -> void;
+
+/// Scale a vector and add another one, i.e. for each coefficient
+/// `y_i = a * y_i + x_i`
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto scale_add(float a, const Vector &x, Vector &y) -> void;
+
+/// Linear interpolation towards `x`, i.e. for each coefficient
+/// `y_i = y_i + t * (x_i - y_i)`. `t = 0` keeps `y`, `t = 1` yields `x`.
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto lerp(const Vector &x, float t, Vector &y) -> void;
+} // namespace linalg
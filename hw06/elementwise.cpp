@@ -0,0 +1,186 @@
+#include "elementwise.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// The polynomials and the range reductions follow the single precision
+// routines of the Cephes math library. All branches are written as selects, so
+// the loops in `map` and `map_inplace` stay vectorizable.
+
+namespace linalg {
+namespace {
+
+constexpr float inf = std::numeric_limits<float>::infinity();
+constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+
+// ln(2) split into an exactly representable high part and a small remainder
+constexpr float ln2_hi = 0.693359375f;
+constexpr float ln2_lo = -2.12194440e-4f;
+
+// round to the nearest integer, valid for |x| < 2^22
+float round_nearest(float x) {
+    constexpr float magic = 12582912.0f; // 1.5 * 2^23
+    return (x + magic) - magic;
+}
+
+float exp_kernel(float x) {
+    constexpr float max_arg = 88.72283935546875f;
+    constexpr float min_arg = -87.33654022216797f;
+    float c = x < min_arg ? min_arg : (x > max_arg ? max_arg : x);
+
+    // exp(x) = 2^k * exp(r) with |r| <= ln(2) / 2
+    float k = round_nearest(c * 1.44269504088896341f);
+    float r = c - k * ln2_hi;
+    r = r - k * ln2_lo;
+
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+
+    // 2^k built directly in the exponent bits, k is in [-126, 128]. For k = 128
+    // the scaling is split in two steps so it does not overflow the exponent.
+    auto ki = static_cast<std::int32_t>(k);
+    std::int32_t k1 = ki >> 1;
+    float scale1 = std::bit_cast<float>((k1 + 127) << 23);
+    float scale2 = std::bit_cast<float>((ki - k1 + 127) << 23);
+    float out = p * scale1 * scale2;
+
+    out = x > max_arg ? inf : out;
+    out = x < min_arg ? 0.0f : out;
+    return x != x ? x : out;
+}
+
+float log_kernel(float x) {
+    constexpr float sqrt_half = 0.707106781186547524f;
+
+    // x = m * 2^e with m in [0.5, 1)
+    auto bits = std::bit_cast<std::int32_t>(x);
+    float e = static_cast<float>(((bits >> 23) & 0xff) - 126);
+    float m = std::bit_cast<float>((bits & 0x007fffff) | 0x3f000000);
+
+    // move m into [sqrt(0.5), sqrt(2)) and subtract one
+    bool small = m < sqrt_half;
+    e = small ? e - 1.0f : e;
+    m = small ? m + m - 1.0f : m - 1.0f;
+
+    float z = m * m;
+    float p = 7.0376836292e-2f;
+    p = p * m - 1.1514610310e-1f;
+    p = p * m + 1.1676998740e-1f;
+    p = p * m - 1.2420140846e-1f;
+    p = p * m + 1.4249322787e-1f;
+    p = p * m - 1.6668057665e-1f;
+    p = p * m + 2.0000714765e-1f;
+    p = p * m - 2.4999993993e-1f;
+    p = p * m + 3.3333331174e-1f;
+
+    float y = p * m * z;
+    y = y + e * ln2_lo;
+    y = y - 0.5f * z;
+    float out = m + y;
+    out = out + e * ln2_hi;
+
+    out = x < std::numeric_limits<float>::min() ? -inf : out;
+    out = x < 0.0f ? nan : out;
+    out = x == inf ? inf : out;
+    return x != x ? x : out;
+}
+
+float tanh_kernel(float x) {
+    float ax = x < 0.0f ? -x : x;
+
+    // small arguments, odd polynomial
+    float z = x * x;
+    float p = -5.70498872745e-3f;
+    p = p * z + 2.06390887954e-2f;
+    p = p * z - 5.37397155531e-2f;
+    p = p * z + 1.33314422036e-1f;
+    p = p * z - 3.33332819422e-1f;
+    float small_arg = p * z * x + x;
+
+    // large arguments, 1 - 2 / (exp(2|x|) + 1) with the sign of x
+    float large_arg = 1.0f - 2.0f / (exp_kernel(ax + ax) + 1.0f);
+    large_arg = x < 0.0f ? -large_arg : large_arg;
+
+    return ax < 0.625f ? small_arg : large_arg;
+}
+
+float abs_kernel(float x) {
+    return std::bit_cast<float>(std::bit_cast<std::uint32_t>(x) & 0x7fffffffu);
+}
+} // namespace
+
+
+Vector exp(const Vector &x) {
+    return map(x, [](float v) { return exp_kernel(v); });
+}
+
+void exp_inplace(Vector &x) {
+    map_inplace(x, [](float v) { return exp_kernel(v); });
+}
+
+Vector log(const Vector &x) {
+    return map(x, [](float v) { return log_kernel(v); });
+}
+
+void log_inplace(Vector &x) {
+    map_inplace(x, [](float v) { return log_kernel(v); });
+}
+
+Vector tanh(const Vector &x) {
+    return map(x, [](float v) { return tanh_kernel(v); });
+}
+
+void tanh_inplace(Vector &x) {
+    map_inplace(x, [](float v) { return tanh_kernel(v); });
+}
+
+Vector sqrt(const Vector &x) {
+    return map(x, [](float v) { return std::sqrt(v); });
+}
+
+void sqrt_inplace(Vector &x) {
+    map_inplace(x, [](float v) { return std::sqrt(v); });
+}
+
+Vector abs(const Vector &x) {
+    return map(x, [](float v) { return abs_kernel(v); });
+}
+
+void abs_inplace(Vector &x) {
+    map_inplace(x, [](float v) { return abs_kernel(v); });
+}
+
+Vector clamp(const Vector &x, float lo, float hi) {
+    Vector y = x;
+    clamp_inplace(y, lo, hi);
+    return y;
+}
+
+void clamp_inplace(Vector &x, float lo, float hi) {
+    if (lo > hi) {throw std::invalid_argument("lower bound above upper bound");}
+    map_inplace(x, [lo, hi](float v) { return v < lo ? lo : (hi < v ? hi : v); });
+}
+
+Vector softmax(const Vector &x) {
+    Vector y = x;
+    softmax_inplace(y);
+    return y;
+}
+
+void softmax_inplace(Vector &x) {
+    if (x.size() == 0) {
+        return;
+    }
+    float shift = max(x);
+    map_inplace(x, [shift](float v) { return exp_kernel(v - shift); });
+    float total = sum(x);
+    x /= total;
+}
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+#include "vector.h"
+#pragma once
+
+namespace linalg {
+
+/* Element-wise transforms. Every transform is available as a function
+ * returning a transformed copy and as an `_inplace` variant modifying the
+ * given vector. The transcendental functions use polynomial approximations
+ * written as branch-free loops, so they are vectorized like the arithmetic
+ * operators instead of calling the scalar C library once per coefficient. */
+
+// A vector overload declared in `linalg` hides the scalar function of the same
+// name for unqualified calls inside the namespace, so `exp(1.f)` would no
+// longer compile there. Bring the scalar overloads in next to them.
+using std::abs;
+using std::clamp;
+using std::exp;
+using std::log;
+using std::sqrt;
+using std::tanh;
+
+/// Apply `f` to each coefficient of `x` in-place, i.e. `x_i = f(x_i)`. Keep
+/// `f` small and branch-free so the loop can be vectorized.
+template <typename F> auto map_inplace(Vector &x, F f) -> void {
+  float *px = x.data();
+  std::size_t n = x.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    px[i] = f(px[i]);
+  }
+}
+
+/// Return a copy for which `f` is applied to every coefficient, i.e.
+/// `v_i = f(x_i)`
+template <typename F> auto map(const Vector &x, F f) -> Vector {
+  Vector y(x.size());
+  const float *px = x.data();
+  float *py = y.data();
+  std::size_t n = x.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    py[i] = f(px[i]);
+  }
+  return y;
+}
+
+/// Return a copy for which every coefficient is `v_i = exp(x_i)`.
+///
+/// The maximal error is 1 ULP for results in the normal range. Results below
+/// the smallest normal float are flushed to zero, results above the largest
+/// float are infinity.
+auto exp(const Vector &x) -> Vector;
+
+/// In-place variant of `exp`
+auto exp_inplace(Vector &x) -> void;
+
+/// Return a copy for which every coefficient is `v_i = log(x_i)`.
+///
+/// The maximal error is 1 ULP for normal inputs. Zero and subnormal inputs give
+/// negative infinity, negative inputs give NaN.
+auto log(const Vector &x) -> Vector;
+
+/// In-place variant of `log`
+auto log_inplace(Vector &x) -> void;
+
+/// Return a copy for which every coefficient is `v_i = tanh(x_i)`.
+///
+/// The maximal error is 2 ULP, the result saturates at +-1.
+auto tanh(const Vector &x) -> Vector;
+
+/// In-place variant of `tanh`
+auto tanh_inplace(Vector &x) -> void;
+
+/// Return a copy for which every coefficient is `v_i = sqrt(x_i)`. The result
+/// is correctly rounded, negative inputs give NaN.
+auto sqrt(const Vector &x) -> Vector;
+
+/// In-place variant of `sqrt`
+auto sqrt_inplace(Vector &x) -> void;
+
+/// Return a copy for which every coefficient is `v_i = |x_i|`
+auto abs(const Vector &x) -> Vector;
+
+/// In-place variant of `abs`
+auto abs_inplace(Vector &x) -> void;
+
+/// Return a copy for which every coefficient is limited to the range
+/// `[lo, hi]`
+///
+/// Throw an `std::invalid_argument` exception, if `lo` is greater than `hi`
+auto clamp(const Vector &x, float lo, float hi) -> Vector;
+
+/// In-place variant of `clamp`
+auto clamp_inplace(Vector &x, float lo, float hi) -> void;
+
+/// Return the softmax of the vector, i.e. `v_i = exp(x_i) / sum(exp(x_j))`.
+/// The maximum is subtracted first, so large coefficients do not overflow.
+auto softmax(const Vector &x) -> Vector;
+
+/// In-place variant of `softmax`
+auto softmax_inplace(Vector &x) -> void;
+} // namespace linalg
@@ -1,3 +1,7 @@
 #pragma once
 
 #include "vector.h"
+#include "blas.h"
+#include "elementwise.h"
+#include "similarity.h"
+#include "sparse.h"
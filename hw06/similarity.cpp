@@ -0,0 +1,203 @@
+#include "similarity.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace linalg {
+namespace {
+
+// number of independent accumulators per row, wide enough for one AVX register
+constexpr std::size_t lanes = 8;
+
+// number of rows scored in one pass over the query
+constexpr std::size_t block = 4;
+
+// dot product of the query with one row
+float dot_row(const float *q, const float *r, std::size_t dim) {
+    float acc[lanes] = {};
+    std::size_t i = 0;
+    for (; i + lanes <= dim; i += lanes) {
+        for (std::size_t l = 0; l < lanes; ++l) {
+            acc[l] += q[i + l] * r[i + l];
+        }
+    }
+    float out = 0.0f;
+    for (; i < dim; ++i) {
+        out += q[i] * r[i];
+    }
+    for (std::size_t l = 0; l < lanes; ++l) {
+        out += acc[l];
+    }
+    return out;
+}
+
+// dot products of the query with `block` consecutive rows, every query
+// coefficient is loaded once for all rows
+void dot_block(const float *q, const float *r, std::size_t dim, float *out) {
+    float acc[block][lanes] = {};
+    std::size_t i = 0;
+    for (; i + lanes <= dim; i += lanes) {
+        for (std::size_t b = 0; b < block; ++b) {
+            const float *row = r + b * dim;
+            for (std::size_t l = 0; l < lanes; ++l) {
+                acc[b][l] += q[i + l] * row[i + l];
+            }
+        }
+    }
+    for (std::size_t b = 0; b < block; ++b) {
+        const float *row = r + b * dim;
+        float sum = 0.0f;
+        for (std::size_t j = i; j < dim; ++j) {
+            sum += q[j] * row[j];
+        }
+        for (std::size_t l = 0; l < lanes; ++l) {
+            sum += acc[b][l];
+        }
+        out[b] = sum;
+    }
+}
+
+// ordering of matches, higher scores first and lower indices on ties
+bool better(const Match &a, const Match &b) {
+    return a.score > b.score || (a.score == b.score && a.index < b.index);
+}
+
+// keeps the best `k` matches, `heap.front()` is the worst of them
+void offer(std::vector<Match> &heap, std::size_t k, Match m) {
+    if (heap.size() < k) {
+        heap.push_back(m);
+        std::push_heap(heap.begin(), heap.end(), better);
+    } else if (better(m, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = m;
+        std::push_heap(heap.begin(), heap.end(), better);
+    }
+}
+
+// score rows [first, last) against the normalized query
+void scan(const std::vector<float> &data, std::size_t dim, const float *q,
+          std::size_t first, std::size_t last, std::size_t k,
+          std::vector<Match> &heap) {
+    float scores[block];
+    std::size_t row = first;
+    for (; row + block <= last; row += block) {
+        dot_block(q, data.data() + row * dim, dim, scores);
+        for (std::size_t b = 0; b < block; ++b) {
+            offer(heap, k, {row + b, scores[b]});
+        }
+    }
+    for (; row < last; ++row) {
+        offer(heap, k, {row, dot_row(q, data.data() + row * dim, dim)});
+    }
+}
+
+std::vector<float> normalized_copy(const Vector &x) {
+    std::vector<float> out(x.begin(), x.end());
+    float n = norm(x);
+    if (n > 0.0f) {
+        for (auto &v : out) {
+            v /= n;
+        }
+    }
+    return out;
+}
+} // namespace
+
+
+SimilarityIndex::SimilarityIndex(std::size_t dim) : dim_{dim} {}
+
+std::size_t SimilarityIndex::dim() const {
+    return dim_;
+}
+
+std::size_t SimilarityIndex::size() const {
+    return dim_ == 0 ? 0 : data_.size() / dim_;
+}
+
+void SimilarityIndex::reserve(std::size_t n) {
+    data_.reserve(n * dim_);
+}
+
+std::size_t SimilarityIndex::add(const Vector &x) {
+    if (x.size() != dim_) {throw std::invalid_argument("vector has wrong size");}
+    auto row = normalized_copy(x);
+    data_.insert(data_.end(), row.begin(), row.end());
+    return size() - 1;
+}
+
+std::vector<Match> SimilarityIndex::search(const Vector &query, std::size_t k,
+                                           std::size_t threads) const {
+    if (query.size() != dim_) {throw std::invalid_argument("query has wrong size");}
+    if (threads == 0) {throw std::invalid_argument("need at least one thread");}
+
+    auto q = normalized_copy(query);
+    std::size_t rows = size();
+    k = std::min(k, rows);
+    if (k == 0) {
+        return {};
+    }
+
+    // every partition keeps its own heap, they are merged afterwards
+    threads = std::min(threads, (rows + block - 1) / block);
+    std::vector<std::vector<Match>> heaps(threads);
+    std::size_t chunk = (rows / threads + block - 1) / block * block;
+    auto work = [&](std::size_t t) {
+        std::size_t first = std::min(t * chunk, rows);
+        std::size_t last = t + 1 == threads ? rows : std::min(first + chunk, rows);
+        heaps[t].reserve(k);
+        scan(data_, dim_, q.data(), first, last, k, heaps[t]);
+    };
+
+    if (threads == 1) {
+        work(0);
+    } else {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(work, t);
+        }
+    }
+
+    std::vector<Match> out = std::move(heaps[0]);
+    for (std::size_t t = 1; t < threads; ++t) {
+        for (const auto &m : heaps[t]) {
+            offer(out, k, m);
+        }
+    }
+    std::sort(out.begin(), out.end(), better);
+    return out;
+}
+
+std::vector<std::vector<Match>> SimilarityIndex::search(const std::vector<Vector> &queries,
+                                                        std::size_t k,
+                                                        std::size_t threads) const {
+    if (threads == 0) {throw std::invalid_argument("need at least one thread");}
+    for (const auto &query : queries) {
+        if (query.size() != dim_) {throw std::invalid_argument("query has wrong size");}
+    }
+
+    // with many queries it is cheaper to split the queries than the rows
+    std::vector<std::vector<Match>> out(queries.size());
+    if (queries.size() < threads) {
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            out[i] = search(queries[i], k, threads);
+        }
+        return out;
+    }
+
+    auto work = [&](std::size_t t) {
+        for (std::size_t i = t; i < queries.size(); i += threads) {
+            out[i] = search(queries[i], k);
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(work, t);
+        }
+    }
+    return out;
+}
+}
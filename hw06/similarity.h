@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <vector>
+
+#include "vector.h"
+#pragma once
+
+namespace linalg {
+
+/// A single result of a similarity search: the row index of the stored vector
+/// and its cosine similarity to the query
+struct Match {
+  std::size_t index;
+  float score;
+};
+
+/// A collection of many vectors of the same length, used for brute-force
+/// cosine similarity (nearest neighbor) searches.
+///
+/// All vectors are stored normalized and back to back in one contiguous
+/// buffer, so a search is a single streaming pass over memory. Scores are
+/// computed for a block of rows at once, which keeps the query in registers and
+/// lets the compiler vectorize the inner loop.
+class SimilarityIndex {
+public:
+  /// Construct an empty index for vectors with `dim` coefficients
+  explicit SimilarityIndex(std::size_t dim);
+
+  /// Return the number of coefficients of each stored vector
+  auto dim() const -> std::size_t;
+
+  /// Return the number of stored vectors
+  auto size() const -> std::size_t;
+
+  /// Reserve memory for `n` vectors, so adding them does not reallocate
+  auto reserve(std::size_t n) -> void;
+
+  /// Store a normalized copy of `x` and return its row index. A vector with
+  /// norm zero is stored as is, i.e. it has a similarity of zero to everything.
+  ///
+  /// Throw an `std::invalid_argument` exception, if `x` is not of size `dim()`
+  auto add(const Vector &x) -> std::size_t;
+
+  /// Return the `k` stored vectors with the highest cosine similarity to
+  /// `query`, ordered from the best to the worst match. Ties are ordered by
+  /// row index. The stored rows are split into `threads` partitions which are
+  /// searched concurrently.
+  ///
+  /// Throw an `std::invalid_argument` exception, if `query` is not of size
+  /// `dim()` or if `threads` is zero
+  auto search(const Vector &query, std::size_t k,
+              std::size_t threads = 1) const -> std::vector<Match>;
+
+  /// Run `search` for every vector in `queries`
+  auto search(const std::vector<Vector> &queries, std::size_t k,
+              std::size_t threads = 1) const
+      -> std::vector<std::vector<Match>>;
+
+private:
+  std::size_t dim_;
+  std::vector<float> data_;
+};
+} // namespace linalg
@@ -0,0 +1,153 @@
+#include "sparse.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace linalg {
+
+SparseVector::SparseVector(std::size_t n) : size_{n} {}
+
+SparseVector::SparseVector(std::size_t n, std::vector<std::size_t> indices,
+                           std::vector<float> values)
+    : size_{n}, indices_{std::move(indices)}, values_{std::move(values)} {
+    if (indices_.size() != values_.size()) {throw std::invalid_argument("indices and values have diff size");}
+    for (std::size_t i = 0; i < indices_.size(); ++i) {
+        if (indices_[i] >= size_) {throw std::invalid_argument("index out of bounds");}
+        if (i > 0 && indices_[i - 1] >= indices_[i]) {throw std::invalid_argument("indices not increasing");}
+    }
+}
+
+SparseVector::SparseVector(const Vector &x) : size_{x.size()} {
+    auto nnz = non_zeros(x);
+    indices_.reserve(nnz);
+    values_.reserve(nnz);
+    std::size_t i = 0;
+    for (float v : x) {
+        if (v != 0.0f) {
+            indices_.push_back(i);
+            values_.push_back(v);
+        }
+        ++i;
+    }
+}
+
+std::size_t SparseVector::size() const {
+    return size_;
+}
+
+const std::vector<std::size_t>& SparseVector::indices() const {
+    return indices_;
+}
+
+const std::vector<float>& SparseVector::values() const {
+    return values_;
+}
+
+float SparseVector::coeff(std::size_t idx) const {
+    if (idx >= size_) {throw std::out_of_range("idx out of bounds");}
+    auto it = std::lower_bound(indices_.begin(), indices_.end(), idx);
+    if (it == indices_.end() || *it != idx) {
+        return 0.0f;
+    }
+    return values_[static_cast<std::size_t>(it - indices_.begin())];
+}
+
+SparseVector& SparseVector::operator*=(float val) {
+    for (auto &x : values_) {
+        x *= val;
+    }
+    return *this;
+}
+
+SparseVector& SparseVector::operator/=(float val) {
+    for (auto &x : values_) {
+        x /= val;
+    }
+    return *this;
+}
+
+
+std::ostream& operator<<(std::ostream& ostr, const SparseVector& x) {
+    ostr << "[ ";
+    for (std::size_t i = 0; i < x.indices().size(); ++i) {
+        ostr << x.indices()[i] << ":" << x.values()[i] << " ";
+    }
+    ostr << "]";
+    return ostr;
+}
+
+Vector to_dense(const SparseVector &x) {
+    Vector y(x.size(), 0.0f);
+    y += x;
+    return y;
+}
+
+std::size_t non_zeros(const SparseVector &x) {
+    return x.values().size();
+}
+
+float dot(const SparseVector &x, const Vector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors of diff size");}
+    auto dense = y.begin();
+    const auto &idx = x.indices();
+    const auto &val = x.values();
+    float out = 0.0f;
+    for (std::size_t i = 0; i < idx.size(); ++i) {
+        out += val[i] * dense[static_cast<std::ptrdiff_t>(idx[i])];
+    }
+    return out;
+}
+
+float dot(const Vector &x, const SparseVector &y) {
+    return dot(y, x);
+}
+
+float dot(const SparseVector &x, const SparseVector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors of diff size");}
+    const auto &xi = x.indices();
+    const auto &yi = y.indices();
+    std::size_t i = 0;
+    std::size_t j = 0;
+    float out = 0.0f;
+    while (i < xi.size() && j < yi.size()) {
+        if (xi[i] < yi[j]) {
+            ++i;
+        } else if (yi[j] < xi[i]) {
+            ++j;
+        } else {
+            out += x.values()[i++] * y.values()[j++];
+        }
+    }
+    return out;
+}
+
+float norm(const SparseVector &x) {
+    float out = 0.0f;
+    for (float v : x.values()) {
+        out += v * v;
+    }
+    return std::sqrt(out);
+}
+
+Vector& operator+=(Vector &x, const SparseVector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    auto dense = x.begin();
+    const auto &idx = y.indices();
+    const auto &val = y.values();
+    for (std::size_t i = 0; i < idx.size(); ++i) {
+        dense[static_cast<std::ptrdiff_t>(idx[i])] += val[i];
+    }
+    return x;
+}
+
+Vector& operator-=(Vector &x, const SparseVector &y) {
+    if (x.size() != y.size()) {throw std::invalid_argument("vectors have diff size");}
+    auto dense = x.begin();
+    const auto &idx = y.indices();
+    const auto &val = y.values();
+    for (std::size_t i = 0; i < idx.size(); ++i) {
+        dense[static_cast<std::ptrdiff_t>(idx[i])] -= val[i];
+    }
+    return x;
+}
+}
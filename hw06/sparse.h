@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "vector.h"
+#pragma once
+
+namespace linalg {
+
+/// A vector where only the non-zero coefficients are stored. The indices of
+/// the non-zero coefficients are kept sorted, together with their values in a
+/// second array of the same length. All other coefficients are zero.
+class SparseVector {
+public:
+  /// Default constructor
+  SparseVector() = default;
+
+  /// Construct a vector of the given size with all coefficients zero
+  explicit SparseVector(std::size_t n);
+
+  /// Construct a vector of size `n` from the non-zero coefficients. `indices`
+  /// must be strictly increasing and `values[i]` is the coefficient at
+  /// `indices[i]`.
+  ///
+  /// Throw an `std::invalid_argument` exception, if `indices` and `values` are
+  /// of different size, `indices` is not strictly increasing or any index is
+  /// not smaller than `n`
+  SparseVector(std::size_t n, std::vector<std::size_t> indices,
+               std::vector<float> values);
+
+  /// Construct a vector from a dense one, only keeping the non-zero
+  /// coefficients
+  explicit SparseVector(const Vector &x);
+
+  /// Return the size of the vector, including the zero coefficients
+  auto size() const -> std::size_t;
+
+  /// Return the sorted indices of the stored coefficients
+  auto indices() const -> const std::vector<std::size_t> &;
+
+  /// Return the values of the stored coefficients
+  auto values() const -> const std::vector<float> &;
+
+  /// Return the idx-th coefficient of the vector, zero if it is not stored
+  ///
+  /// Throw an `std::out_of_range` exception if the index out of bounds.
+  auto coeff(std::size_t idx) const -> float;
+
+  /// Multiply vector with a scalar, only the stored coefficients are touched
+  auto operator*=(float val) -> SparseVector &;
+
+  /// Divide vector by a scalar, only the stored coefficients are touched
+  auto operator/=(float val) -> SparseVector &;
+
+private:
+  std::size_t size_ = 0;
+  std::vector<std::size_t> indices_;
+  std::vector<float> values_;
+};
+
+/// This will pretty print a sparse vector as `idx:value` pairs
+auto operator<<(std::ostream &ostr, const SparseVector &x) -> std::ostream &;
+
+/// Return a dense copy of the given vector
+auto to_dense(const SparseVector &x) -> Vector;
+
+/// Return the number of stored coefficients of the vector
+auto non_zeros(const SparseVector &x) -> std::size_t;
+
+/// Return the dot product of the two vectors, only the stored coefficients of
+/// `x` are visited
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto dot(const SparseVector &x, const Vector &y) -> float;
+
+/// Return the dot product of the two vectors, only the stored coefficients of
+/// `y` are visited
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto dot(const Vector &x, const SparseVector &y) -> float;
+
+/// Return the dot product of the two vectors by merging the sorted indices of
+/// both
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto dot(const SparseVector &x, const SparseVector &y) -> float;
+
+/// Return the euclidean norm of the vector
+auto norm(const SparseVector &x) -> float;
+
+/// In-place addition of a sparse vector to a dense one, only the stored
+/// coefficients of `y` are added (scattered) into `x`
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto operator+=(Vector &x, const SparseVector &y) -> Vector &;
+
+/// In-place subtraction of a sparse vector from a dense one
+///
+/// Throw an `std::invalid_argument` exceptions, if the given vector is of a
+/// different size
+auto operator-=(Vector &x, const SparseVector &y) -> Vector &;
+} // namespace linalg
@@ -73,6 +73,14 @@ Vector::const_iterator Vector::cend() const {
     return Vector::data_.end();
 }
 
+float* Vector::data() {
+    return Vector::data_.data();
+}
+
+const float* Vector::data() const {
+    return Vector::data_.data();
+}
+
 float& Vector::operator[](int idx) {
     if (idx>=0) {
         return Vector::data_.at(idx);
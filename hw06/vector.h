@@ -60,6 +60,12 @@ public:
   /// Return an end const_iterator to the vector
   auto cend() const -> const_iterator;
 
+  /// Return a pointer to the contiguous coefficients of the vector
+  auto data() -> float *;
+
+  /// Return a pointer to the contiguous coefficients of the vector
+  auto data() const -> const float *;
+
   /// Access a modifiable reference to the idx-th element of the vector.#
   ///
   /// Additionally a python like behaviour access of negative indices should be
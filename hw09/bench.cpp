@@ -0,0 +1,205 @@
+#include "hw09.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Benchmarks for the hw09 containers.
+ *
+ * usage: vector_bench [repetitions]
+ *
+ * The repetitions (default 10^6) are divided by up to 10^4 for the slower
+ * benchmarks, so at least 10^4 are required.
+ *
+ * Configure with -DCMAKE_BUILD_TYPE=Release, debug numbers are meaningless.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Results must go somewhere, otherwise the compiler removes the work
+volatile size_t sink;
+
+/// Run `f` `reps` times and print the average time per repetition
+void report(const std::string& name, size_t reps, const std::function<void()>& f) {
+    auto start = clock_type::now();
+    for (size_t i = 0; i < reps; ++i) {
+        f();
+    }
+    auto stop = clock_type::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    std::cout << std::left << std::setw(48) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << ns / static_cast<double>(reps)
+              << " ns\n";
+}
+
+template <typename T>
+T make_value(size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return "a fairly long string that does not fit SSO " + std::to_string(i);
+    } else {
+        return static_cast<T>(i);
+    }
+}
+
+/// Create a vector, fill it with `count` elements, copy it and destroy both
+template <typename Container>
+void fill_and_copy(size_t count) {
+    Container v{};
+    for (size_t i = 0; i < count; ++i) {
+        v.push_back(make_value<std::remove_cvref_t<decltype(v[0])>>(i));
+    }
+    Container copy{v};
+    sink = copy.size();
+}
+
+template <typename T, size_t N>
+void compare_small(size_t reps, const std::string& type) {
+    for (size_t count : {size_t{1}, N / 2, N, 2 * N}) {
+        std::string suffix = "<" + type + "> fill+copy " + std::to_string(count);
+        report("Vector" + suffix, reps, [count] { fill_and_copy<Vector<T>>(count); });
+        report("SmallVector<" + std::to_string(N) + ">" + suffix, reps,
+               [count] { fill_and_copy<SmallVector<T, N>>(count); });
+    }
+}
+
+/// Grow a vector from empty to `count` elements, with and without reserving
+template <typename T>
+void push_vs_reserve(size_t reps, size_t count, const std::string& type) {
+    report("Vector<" + type + "> push_back " + std::to_string(count), reps, [count] {
+        Vector<T> v{};
+        for (size_t i = 0; i < count; ++i) {
+            v.push_back(make_value<T>(i));
+        }
+        sink = v.size();
+    });
+    report("Vector<" + type + "> reserve+emplace_back " + std::to_string(count), reps, [count] {
+        Vector<T> v{};
+        v.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            v.emplace_back(make_value<T>(i));
+        }
+        sink = v.size();
+    });
+}
+
+/// Fill vectors with the `Growth` policy up to every size from 1 to `count`.
+/// Print the push_back time per element, the reallocations and how much of the
+/// capacity is unused on average and at worst over all these sizes.
+template <typename T, typename Growth>
+void policy(size_t reps, size_t count, const std::string& name) {
+    using V = Vector<T, std::allocator<T>, Growth>;
+    auto start = clock_type::now();
+    for (size_t r = 0; r < reps; ++r) {
+        V v{};
+        for (size_t i = 0; i < count; ++i) {
+            v.push_back(make_value<T>(i));
+        }
+        sink = v.size();
+    }
+    auto stop = clock_type::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+    V v{};
+    size_t reallocations = 0;
+    double unused = 0;
+    double worst = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t before = v.capacity();
+        v.push_back(make_value<T>(i));
+        reallocations += v.capacity() != before;
+        double fraction = static_cast<double>(v.capacity() - v.size()) / static_cast<double>(v.capacity());
+        unused += fraction;
+        worst = std::max(worst, fraction);
+    }
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << ns / static_cast<double>(reps * count) << " ns" << std::setw(10) << reallocations
+              << std::setw(11) << 100 * unused / static_cast<double>(count) << " %" << std::setw(10) << 100 * worst
+              << " %\n";
+}
+
+template <typename T>
+void compare_policies(size_t reps, size_t count, const std::string& type) {
+    std::cout << "Vector<" << type << "> push_back " << count << "\n";
+    std::cout << std::left << std::setw(24) << "policy" << std::right << std::setw(15) << "per element"
+              << std::setw(10) << "reallocs" << std::setw(13) << "avg unused" << std::setw(12) << "max unused"
+              << "\n";
+    policy<T, growth::Doubling>(reps, count, "Doubling");
+    policy<T, growth::OneAndHalf>(reps, count, "OneAndHalf");
+    policy<T, growth::PageRounded<>>(reps, count, "PageRounded");
+    policy<T, growth::SizeClass>(reps, count, "SizeClass");
+}
+
+/// Append `count` elements from `threads` producers, each appending its share
+template <typename Append>
+double append_from_threads(size_t threads, size_t count, Append append) {
+    auto start = clock_type::now();
+    {
+        std::vector<std::jthread> producers;
+        for (size_t t = 0; t < threads; ++t) {
+            producers.emplace_back([=, &append] {
+                for (size_t i = t; i < count; i += threads) {
+                    append(i);
+                }
+            });
+        }
+    }
+    auto stop = clock_type::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(count);
+}
+
+/// Compare appending to a mutex guarded Vector with appending to a ConcurrentVector
+void contention(size_t count) {
+    std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(22) << "Vector + mutex"
+              << std::setw(22) << "ConcurrentVector" << "\n";
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        Vector<size_t> guarded{};
+        std::mutex m;
+        double locked = append_from_threads(threads, count, [&](size_t i) {
+            std::lock_guard lock{m};
+            guarded.push_back(i);
+        });
+
+        ConcurrentVector<size_t> concurrent{};
+        double lock_free = append_from_threads(threads, count, [&](size_t i) { concurrent.push_back(i); });
+        sink = guarded.size() + concurrent.size();
+
+        std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(19) << locked << " ns" << std::setw(19) << lock_free << " ns\n";
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t reps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    if (reps < 10'000) {
+        std::cerr << "usage: vector_bench [repetitions], with at least 10000 repetitions\n";
+        return 2;
+    }
+
+    std::cout << "== Vector vs SmallVector\n";
+    compare_small<int, 8>(reps, "int");
+    compare_small<std::string, 4>(reps / 10, "string");
+
+    std::cout << "\n== growth\n";
+    push_vs_reserve<int>(reps / 1000, 100'000, "int");
+    push_vs_reserve<std::string>(reps / 10'000, 100'000, "string");
+
+    std::cout << "\n== growth policies\n";
+    compare_policies<int>(reps / 1000, 100'000, "int");
+    compare_policies<std::string>(reps / 10'000, 100'000, "string");
+
+    std::cout << "\n== concurrent push_back, time per element\n";
+    contention(reps * 10);
+    return 0;
+}
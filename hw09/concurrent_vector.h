@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * A vector many threads can append to at the same time without locks.
+ *
+ * Unlike `Vector<T>` the elements are never moved: they are stored in
+ * segments of geometrically growing size (FirstSegment, 2 * FirstSegment,
+ * 4 * FirstSegment, ...), which are allocated once and only released by the
+ * destructor. Pointers and references to elements stay valid for the lifetime
+ * of the vector.
+ *
+ * `push_back` reserves a slot with a single atomic increment, constructs the
+ * element and sets its bit in the ready bitmap of the segment. The producer
+ * reserving the middle slot of a segment allocates the next one, so each
+ * segment is normally allocated by a single thread before anybody needs it.
+ * Only a producer outrunning that allocation installs the segment itself with a
+ * compare-and-swap, so `push_back` still finishes in a bounded number of steps
+ * no matter what the other threads do. Readers see the published prefix: all
+ * elements up to the first one which is still being constructed. `size()`,
+ * `operator[]` and iteration over that prefix do not lock either.
+ *
+ * Destruction is not thread-safe, all producers and readers have to be done.
+ */
+template <typename T, size_t FirstSegment = 64>
+class ConcurrentVector {
+    static_assert(std::has_single_bit(FirstSegment), "the first segment size has to be a power of two");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    class const_iterator;
+
+    /**
+     * Creates an empty vector. The first segment is allocated right away, so
+     * producers starting together do not race to allocate it.
+     */
+    ConcurrentVector();
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector();
+
+    /**
+     * Appends the given element value to the end of the vector.
+     * Returns the index of the new element.
+     */
+    size_t push_back(const T& value) { return emplace_back(value); }
+
+    /**
+     * Appends the given element value to the end of the vector.
+     * Returns the index of the new element.
+     */
+    size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    /**
+     * Constructs a new element at the end of the vector from args.
+     * Returns the index of the new element. The element is published as soon as
+     * all elements before it are constructed as well.
+     * If allocating a segment or constructing the element throws, the slot and all
+     * following elements are never published.
+     */
+    template <typename... Args>
+    size_t emplace_back(Args&&... args);
+
+    /**
+     * Returns the number of published elements. The value only grows.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Returns the number of reserved slots, including elements still under construction.
+     */
+    size_t reserved() const noexcept { return _reserved.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns a reference to the element at location pos, which has to be below a size()
+     * seen by the calling thread. No bounds checking is performed.
+     */
+    const T& operator[](const size_t pos) const noexcept { return *element(pos); }
+
+    /**
+     * Returns a reference to the element at location pos, which has to be below a size()
+     * seen by the calling thread. No bounds checking is performed.
+     */
+    T& operator[](const size_t pos) noexcept { return *element(pos); }
+
+    /**
+     * Returns a reference to the element at specified location pos, with bounds checking.
+     * If pos is not within the published prefix, an exception of type std::out_of_range is thrown.
+     */
+    const T& at(const size_t pos) const;
+
+    /**
+     * Iterates over the elements published when begin() is called.
+     */
+    const_iterator begin() const noexcept { return const_iterator(this, 0, size()); }
+
+    const_iterator end() const noexcept { return const_iterator(this, size(), 0); }
+
+private:
+    // A segment is one block of memory: the storage of its elements, followed by
+    // one bit per element telling readers the element is constructed.
+    using ready_word = std::atomic<std::uint64_t>;
+
+    static constexpr size_t word_bits = 64;
+
+    static constexpr size_t first_bits = std::countr_zero(FirstSegment);
+
+    // more segments than any vector fitting into memory can use
+    static constexpr size_t max_segments = sizeof(size_t) * 8 - first_bits;
+
+    static constexpr std::align_val_t segment_alignment{alignof(T) > alignof(ready_word) ? alignof(T)
+                                                                                          : alignof(ready_word)};
+
+    std::atomic<std::byte*> _segments[max_segments] = {};
+
+    // slots handed out to producers
+    std::atomic<size_t> _reserved{0};
+
+    // lower bound of the published prefix, advanced by readers
+    mutable std::atomic<size_t> _published{0};
+
+    static size_t segment_of(size_t pos) noexcept {
+        return std::bit_width((pos >> first_bits) + 1) - 1;
+    }
+
+    static size_t segment_begin(size_t segment) noexcept { return (FirstSegment << segment) - FirstSegment; }
+
+    static size_t segment_size(size_t segment) noexcept { return FirstSegment << segment; }
+
+    // offset of the ready bits behind the elements
+    static size_t bits_offset(size_t segment) noexcept {
+        size_t bytes = segment_size(segment) * sizeof(T);
+        return (bytes + alignof(ready_word) - 1) / alignof(ready_word) * alignof(ready_word);
+    }
+
+    static size_t segment_bytes(size_t segment) noexcept {
+        return bits_offset(segment) + (segment_size(segment) + word_bits - 1) / word_bits * sizeof(ready_word);
+    }
+
+    static T* element(std::byte* slots, size_t i) noexcept {
+        return std::launder(reinterpret_cast<T*>(slots + i * sizeof(T)));
+    }
+
+    // the word holding the ready bit of element i
+    static ready_word& ready(std::byte* slots, size_t segment, size_t i) noexcept {
+        return reinterpret_cast<ready_word*>(slots + bits_offset(segment))[i / word_bits];
+    }
+
+    static std::byte* allocate_segment(size_t segment);
+
+    static void deallocate_segment(std::byte* slots, size_t segment) noexcept;
+
+    /**
+     * Returns the element at pos, whose segment has to exist.
+     */
+    T* element(size_t pos) const noexcept;
+
+    /**
+     * Returns the segment, allocating and installing it if no other thread did so yet.
+     */
+    std::byte* acquire_segment(size_t segment);
+};
+
+template <typename T, size_t FirstSegment>
+class ConcurrentVector<T, FirstSegment>::const_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const noexcept { return (*_vector)[_pos]; }
+
+    pointer operator->() const noexcept { return &(*_vector)[_pos]; }
+
+    const_iterator& operator++() noexcept {
+        ++_pos;
+        return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+        const_iterator old = *this;
+        ++_pos;
+        return old;
+    }
+
+    friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+        // an iterator created by begin() reaches the end at the size it saw
+        return a.at_end() == b.at_end() && (a.at_end() || a._pos == b._pos);
+    }
+
+private:
+    friend class ConcurrentVector;
+
+    const_iterator(const ConcurrentVector* vector, size_t pos, size_t limit) noexcept
+        : _vector{vector}, _pos{pos}, _limit{limit} {}
+
+    bool at_end() const noexcept { return _pos >= _limit; }
+
+    const ConcurrentVector* _vector = nullptr;
+    size_t _pos = 0;
+    size_t _limit = 0;
+};
+
+//out-of-line definitions
+template <typename T, size_t FirstSegment>
+ConcurrentVector<T, FirstSegment>::ConcurrentVector() {
+    _segments[0].store(allocate_segment(0), std::memory_order_relaxed);
+}
+
+template <typename T, size_t FirstSegment>
+ConcurrentVector<T, FirstSegment>::~ConcurrentVector() {
+    size_t count = _reserved.load(std::memory_order_acquire);
+    for (size_t segment = 0; segment < max_segments; segment++) {
+        std::byte* slots = _segments[segment].load(std::memory_order_acquire);
+        if (slots == nullptr) {
+            continue;
+        }
+        size_t first = segment_begin(segment);
+        for (size_t i = 0; i < segment_size(segment) && first + i < count; i++) {
+            if (ready(slots, segment, i).load(std::memory_order_acquire) & (std::uint64_t{1} << (i % word_bits))) {
+                std::destroy_at(element(slots, i));
+            }
+        }
+        deallocate_segment(slots, segment);
+    }
+}
+
+template <typename T, size_t FirstSegment>
+template <typename... Args>
+size_t ConcurrentVector<T, FirstSegment>::emplace_back(Args&&... args) {
+    size_t pos = _reserved.fetch_add(1, std::memory_order_relaxed);
+    size_t segment = segment_of(pos);
+    size_t i = pos - segment_begin(segment);
+    // exactly one producer reserves the middle slot, it allocates the next segment while
+    // the other half of this one is filled
+    if (i == segment_size(segment) / 2 && segment + 1 < max_segments) {
+        acquire_segment(segment + 1);
+    }
+    std::byte* slots = acquire_segment(segment);
+    std::construct_at(element(slots, i), std::forward<Args>(args)...);
+    ready(slots, segment, i).fetch_or(std::uint64_t{1} << (i % word_bits), std::memory_order_release);
+    return pos;
+}
+
+template <typename T, size_t FirstSegment>
+size_t ConcurrentVector<T, FirstSegment>::size() const noexcept {
+    size_t published = _published.load(std::memory_order_acquire);
+    size_t count = published;
+    size_t reserved = _reserved.load(std::memory_order_relaxed);
+    while (count < reserved) {
+        size_t segment = segment_of(count);
+        std::byte* slots = _segments[segment].load(std::memory_order_acquire);
+        if (slots == nullptr) {
+            break;
+        }
+        // skip over all ready elements of the word at once, a word may reach past a small segment
+        size_t i = count - segment_begin(segment);
+        std::uint64_t word = ready(slots, segment, i).load(std::memory_order_acquire) >> (i % word_bits);
+        size_t done = static_cast<size_t>(std::countr_one(word));
+        count += done;
+        if (done < std::min(word_bits - i % word_bits, segment_size(segment) - i)) {
+            break;
+        }
+    }
+    // remember the progress for the next reader, unless another one got further already
+    while (count > published &&
+           !_published.compare_exchange_weak(published, count, std::memory_order_release, std::memory_order_acquire)) {
+    }
+    return count > published ? count : published;
+}
+
+template <typename T, size_t FirstSegment>
+const T& ConcurrentVector<T, FirstSegment>::at(const size_t pos) const {
+    if (pos >= size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[pos];
+}
+
+template <typename T, size_t FirstSegment>
+std::byte* ConcurrentVector<T, FirstSegment>::allocate_segment(size_t segment) {
+    auto* slots = static_cast<std::byte*>(::operator new(segment_bytes(segment), segment_alignment));
+    for (size_t w = 0; w * word_bits < segment_size(segment); w++) {
+        std::construct_at(&ready(slots, segment, w * word_bits), 0);
+    }
+    return slots;
+}
+
+template <typename T, size_t FirstSegment>
+void ConcurrentVector<T, FirstSegment>::deallocate_segment(std::byte* slots, size_t segment) noexcept {
+    ::operator delete(slots, segment_bytes(segment), segment_alignment);
+}
+
+template <typename T, size_t FirstSegment>
+T* ConcurrentVector<T, FirstSegment>::element(size_t pos) const noexcept {
+    size_t segment = segment_of(pos);
+    return element(_segments[segment].load(std::memory_order_acquire), pos - segment_begin(segment));
+}
+
+template <typename T, size_t FirstSegment>
+std::byte* ConcurrentVector<T, FirstSegment>::acquire_segment(size_t segment) {
+    std::byte* slots = _segments[segment].load(std::memory_order_acquire);
+    if (slots != nullptr) {
+        return slots;
+    }
+    // the producer allocating ahead is late, do not wait for it
+    std::byte* fresh = allocate_segment(segment);
+    if (_segments[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return fresh;
+    }
+    // another producer installed the segment first, use theirs
+    deallocate_segment(fresh, segment);
+    return slots;
+}
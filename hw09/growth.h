@@ -0,0 +1,90 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+
+/**
+ * Growth policies for `Vector<T, Allocator, Growth>`.
+ *
+ * A policy is a type with a static function
+ * `next_capacity(capacity, required, element_size)`, which is called whenever
+ * the vector has to grow from `capacity` to hold at least `required` elements
+ * of `element_size` bytes. It returns the new capacity, which has to be at
+ * least `required`. Policies are stateless, so they do not add to the size of
+ * a vector.
+ */
+namespace growth {
+
+template <typename P>
+concept Policy = requires(size_t capacity, size_t required, size_t element_size) {
+    { P::next_capacity(capacity, required, element_size) } -> std::same_as<size_t>;
+};
+
+/**
+ * Doubles the capacity. Few reallocations, but up to half of the memory may be unused.
+ */
+struct Doubling {
+    static size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+        return capacity * 2 > required ? capacity * 2 : required;
+    }
+};
+
+/**
+ * Grows the capacity by half. Wastes at most a third of the memory and lets the
+ * allocator reuse previously freed blocks, at the cost of more reallocations.
+ */
+struct OneAndHalf {
+    static size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+        size_t grown = capacity + capacity / 2;
+        return grown > required ? grown : required;
+    }
+};
+
+/**
+ * Doubles the capacity and rounds the allocation up to whole pages once it is
+ * larger than a page. Large allocations are served as whole pages by the
+ * operating system, so the rounding turns the tail of the last page into usable
+ * capacity instead of leaving it unused.
+ */
+template <size_t PageSize = 4096>
+struct PageRounded {
+    static_assert(std::has_single_bit(PageSize), "page size has to be a power of two");
+
+    static size_t next_capacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        size_t grown = Doubling::next_capacity(capacity, required, element_size);
+        size_t bytes = grown * element_size;
+        if (bytes <= PageSize) {
+            return grown;
+        }
+        bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+        return bytes / element_size;
+    }
+};
+
+/**
+ * Grows the capacity by half and rounds the allocation up to the next size
+ * class of jemalloc (and similar allocators like tcmalloc or mimalloc).
+ * These allocators hand out blocks of 8 and 16 byte steps up to 128 bytes and
+ * four classes per power of two above, so a request between two classes gets
+ * the larger block anyway. Rounding up makes that slack usable.
+ */
+struct SizeClass {
+    static size_t size_class(size_t bytes) noexcept {
+        if (bytes <= 8) {
+            return 8;
+        }
+        if (bytes <= 128) {
+            return (bytes + 15) & ~size_t{15};
+        }
+        // bytes lies in (2^k, 2^(k+1)], which is split into four classes
+        size_t spacing = std::bit_floor(bytes - 1) / 4;
+        return (bytes + spacing - 1) & ~(spacing - 1);
+    }
+
+    static size_t next_capacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        size_t grown = OneAndHalf::next_capacity(capacity, required, element_size);
+        return size_class(grown * element_size) / element_size;
+    }
+};
+} // namespace growth
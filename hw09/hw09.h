@@ -1,3 +1,5 @@
 #pragma once
 
 #include "vector.h"
+#include "small_vector.h"
+#include "concurrent_vector.h"
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A vector with the same interface as `Vector<T>`, which stores up to N
+ * elements inside the object itself. Only if more elements are added, they
+ * are moved to the heap. Creating, copying and destroying small vectors
+ * therefore does not allocate at all.
+ */
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs an inline capacity of at least one element");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallVector() noexcept : _data{inline_data()} {}
+
+    /**
+     * Creates a vector of size n with values default_val.
+     */
+    SmallVector(size_t n, const T& default_val);
+
+    /**
+     * Creates a vector containing the elements in l.
+     */
+    SmallVector(std::initializer_list<T> l);
+
+    SmallVector(const SmallVector& copy);
+
+    SmallVector(SmallVector&& move) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /**
+     * Replaces the contents of the vector.
+     */
+    SmallVector& operator=(const SmallVector& copy);
+
+    /**
+     * Replaces the contents of the vector.
+     */
+    SmallVector& operator=(SmallVector&& move) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    ~SmallVector();
+
+    size_t size() const noexcept { return _size; }
+
+    size_t capacity() const noexcept { return _capacity; }
+
+    /**
+     * Returns true if the elements are stored inside the object.
+     */
+    bool is_inline() const noexcept { return _data == inline_data(); }
+
+    /**
+     * Returns a pointer to the first element. The elements are stored contiguously,
+     * so [data(), data() + size()) is a valid range.
+     */
+    T* data() noexcept { return _data; }
+
+    const T* data() const noexcept { return _data; }
+
+    // The iterators are plain pointers, which makes the vector a contiguous range:
+    // it works with all of <algorithm> and <ranges> and converts to std::span.
+    iterator begin() noexcept { return _data; }
+
+    const_iterator begin() const noexcept { return _data; }
+
+    const_iterator cbegin() const noexcept { return _data; }
+
+    iterator end() noexcept { return _data + _size; }
+
+    const_iterator end() const noexcept { return _data + _size; }
+
+    const_iterator cend() const noexcept { return _data + _size; }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return _size == 0; }
+
+    /**
+     * Appends the given element value to the end of the vector.
+     */
+    void push_back(const T& value);
+
+    /**
+     * Appends the given element value to the end of the vector.
+     */
+    void push_back(T&& value);
+
+    /**
+     * Removes the last element of the vector.
+     */
+    void pop_back();
+
+    /**
+     * Returns a reference to the element at specified location pos, with bounds checking.
+     * If pos is not within the range of the vector, an exception of type std::out_of_range is thrown.
+     */
+    const T& at(const size_t pos) const;
+
+    /**
+     * Returns a reference to the element at specified location pos, with bounds checking.
+     * If pos is not within the range of the vector, an exception of type std::out_of_range is thrown.
+     */
+    T& at(const size_t pos);
+
+    /**
+     * Returns a reference to the element at specified location pos.
+     * No bounds checking is performed.
+     */
+    const T& operator[](const size_t index) const { return _data[index]; }
+
+    /**
+     * Returns a reference to the element at specified location pos.
+     * No bounds checking is performed.
+     */
+    T& operator[](const size_t index) { return _data[index]; }
+
+    friend std::ostream& operator<<(std::ostream& o, const SmallVector& v) {
+        o << "Size: " << v._size << ", Capacity: " << v._capacity << '\n';
+        for (size_t i = 0; i < v._size; ++i) {
+            if (i > 0)
+                o << ", ";
+            o << v._data[i];
+        }
+        o << '\n';
+        return o;
+    }
+
+private:
+    // Points either to `_buffer` or to heap memory.
+    T* _data;
+    size_t _size = 0;
+    size_t _capacity = N;
+
+    // In-object storage for the first N elements.
+    alignas(T) std::byte _buffer[N * sizeof(T)];
+
+    T* inline_data() noexcept { return std::launder(reinterpret_cast<T*>(_buffer)); }
+
+    const T* inline_data() const noexcept { return std::launder(reinterpret_cast<const T*>(_buffer)); }
+
+    /**
+     * Appends a new element constructed from args, growing the storage if needed.
+     * The new element is constructed before the old ones are moved, so args
+     * may refer to an element of this vector.
+     */
+    template <typename... Args>
+    void append(Args&&... args);
+
+    /**
+     * Gives this empty vector heap storage for n elements, if they do not fit inline,
+     * so filling it afterwards allocates once instead of growing step by step.
+     */
+    void allocate_empty(size_t n);
+
+    /**
+     * Destroys all elements and releases the heap memory, if any.
+     * Afterwards the vector is empty and uses its inline storage again.
+     */
+    void reset() noexcept;
+
+    /**
+     * Moves all elements of other into this empty vector and leaves other empty.
+     */
+    void steal(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+};
+
+//out-of-line definitions
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(size_t n, const T& default_val) : SmallVector() {
+    // if a copy throws, the destructor of the delegated constructor releases the memory
+    allocate_empty(n);
+    std::uninitialized_fill_n(_data, n, default_val);
+    _size = n;
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(std::initializer_list<T> l) : SmallVector() {
+    allocate_empty(l.size());
+    std::uninitialized_copy(l.begin(), l.end(), _data);
+    _size = l.size();
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& copy) : SmallVector() {
+    allocate_empty(copy._size);
+    std::uninitialized_copy(copy.begin(), copy.end(), _data);
+    _size = copy._size;
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector&& move) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : SmallVector() {
+    steal(move);
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& copy) {
+    if (&copy == this) {
+        return *this;
+    }
+    SmallVector tmp{copy};
+    reset();
+    steal(tmp);
+    return *this;
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& move) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (&move == this) {
+        return *this;
+    }
+    reset();
+    steal(move);
+    return *this;
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::~SmallVector() {
+    reset();
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::push_back(const T& value) {
+    append(value);
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::push_back(T&& value) {
+    append(std::move(value));
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::pop_back() {
+    if (_size == 0) {
+        throw std::out_of_range("SmallVector<T, N>::pop_back(): vector is empty");
+    }
+    std::destroy_at(_data + --_size);
+}
+
+template <typename T, size_t N>
+const T& SmallVector<T, N>::at(const size_t pos) const {
+    if (pos >= _size) {
+        throw std::out_of_range("Index out of range");
+    }
+    return _data[pos];
+}
+
+template <typename T, size_t N>
+T& SmallVector<T, N>::at(const size_t pos) {
+    if (pos >= _size) {
+        throw std::out_of_range("Index out of range");
+    }
+    return _data[pos];
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+void SmallVector<T, N>::append(Args&&... args) {
+    if (_size < _capacity) {
+        std::construct_at(_data + _size, std::forward<Args>(args)...);
+        ++_size;
+        return;
+    }
+
+    size_t new_capacity = _capacity * 2;
+    std::allocator<T> alloc;
+    T* new_data = alloc.allocate(new_capacity);
+    try {
+        std::construct_at(new_data + _size, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate(new_data, new_capacity);
+        throw;
+    }
+    try {
+        // copy instead of move if moving could throw, so a failure leaves this vector untouched
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move(_data, _data + _size, new_data);
+        } else {
+            std::uninitialized_copy(_data, _data + _size, new_data);
+        }
+    } catch (...) {
+        std::destroy_at(new_data + _size);
+        alloc.deallocate(new_data, new_capacity);
+        throw;
+    }
+
+    size_t size = _size + 1;
+    reset();
+    _data = new_data;
+    _size = size;
+    _capacity = new_capacity;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::allocate_empty(size_t n) {
+    if (n <= N) {
+        return;
+    }
+    _data = std::allocator<T>{}.allocate(n);
+    _capacity = n;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::reset() noexcept {
+    std::destroy(_data, _data + _size);
+    if (!is_inline()) {
+        std::allocator<T>{}.deallocate(_data, _capacity);
+    }
+    _data = inline_data();
+    _size = 0;
+    _capacity = N;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::steal(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (!other.is_inline()) {
+        _data = other._data;
+        _size = other._size;
+        _capacity = other._capacity;
+        other._data = other.inline_data();
+        other._size = 0;
+        other._capacity = N;
+        return;
+    }
+    std::uninitialized_move(other._data, other._data + other._size, _data);
+    _size = other._size;
+    other.reset();
+}
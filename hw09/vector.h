@@ -1,27 +1,84 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <stdexcept>
-
-template <typename T>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "growth.h"
+
+/**
+ * A growable array. All memory is obtained from `Allocator`, which is
+ * propagated on copy, move and swap as its `std::allocator_traits` say.
+ * The allocator has to use plain `T*` pointers.
+ * How much the capacity grows when the vector is full is decided by `Growth`,
+ * see growth.h.
+ */
+template <typename T, typename Allocator = std::allocator<T>, growth::Policy Growth = growth::Doubling>
 class Vector {
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "Allocator has to allocate T");
+    static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Allocator has to use plain pointers");
+
 public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using allocator_type = Allocator;
+
     Vector() = default;
 
+    /**
+     * Creates an empty vector using the given allocator.
+     */
+    explicit Vector(const Allocator& alloc) noexcept : _alloc(alloc) {}
+
     /**
      * Creates a vector of size n with values default_val.
      */
-    Vector(size_t n, const T& default_val);
+    Vector(size_t n, const T& default_val, const Allocator& alloc = Allocator());
 
     /**
      * Creates a vector containing the elements in l.
      */
-    Vector(std::initializer_list<T> l);
+    Vector(std::initializer_list<T> l, const Allocator& alloc = Allocator());
 
     Vector(const Vector& copy);
 
-    Vector(Vector&& move);
+    /**
+     * Creates a copy of the vector using the given allocator.
+     */
+    Vector(const Vector& copy, const Allocator& alloc);
+
+    Vector(Vector&& move) noexcept;
+
+    /**
+     * Moves the vector using the given allocator. If the allocators are not equal,
+     * the elements are moved one by one into new memory.
+     */
+    Vector(Vector&& move, const Allocator& alloc);
 
     /**
      * Replaces the contents of the vector.
@@ -31,13 +88,57 @@ public:
 
     /**
      * Replaces the contents of the vector.
+     * If the allocator does not propagate and is not equal, the elements are moved one by one.
+     */
+    Vector& operator=(Vector&& move) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                              alloc_traits::is_always_equal::value);
+
+    /**
+     * Exchanges the contents with other. The allocators are only exchanged if they propagate on swap,
+     * otherwise they have to be equal.
      */
-    Vector& operator=(Vector&& move) noexcept;
+    void swap(Vector& other) noexcept;
+
+    friend void swap(Vector& a, Vector& b) noexcept { a.swap(b); }
+
+    allocator_type get_allocator() const noexcept { return _alloc; }
 
     size_t size() const noexcept { return _size; }
 
     size_t capacity() const noexcept { return _capacity; }
 
+    /**
+     * Returns a pointer to the first element. The elements are stored contiguously,
+     * so [data(), data() + size()) is a valid range.
+     */
+    T* data() noexcept { return _data; }
+
+    const T* data() const noexcept { return _data; }
+
+    // The iterators are plain pointers, which makes the vector a contiguous range:
+    // it works with all of <algorithm> and <ranges> and converts to std::span.
+    iterator begin() noexcept { return _data; }
+
+    const_iterator begin() const noexcept { return _data; }
+
+    const_iterator cbegin() const noexcept { return _data; }
+
+    iterator end() noexcept { return _data + _size; }
+
+    const_iterator end() const noexcept { return _data + _size; }
+
+    const_iterator cend() const noexcept { return _data + _size; }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return _size == 0; }
+
     /**
      * Appends the given element value to the end of the vector.
      */
@@ -48,16 +149,68 @@ public:
      */
     void push_back(T&& value);
 
+    /**
+     * Constructs a new element in-place at the end of the vector from args.
+     * Returns a reference to the new element.
+     */
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+
     /**
      * Removes the last element of the vector.
      */
     void pop_back();
 
+    /**
+     * Increases the capacity to at least new_capacity, so the following
+     * insertions up to that size do not reallocate.
+     */
+    void reserve(size_t new_capacity);
+
+    /**
+     * Reduces the capacity to the size of the vector.
+     */
+    void shrink_to_fit();
+
+    /**
+     * Changes the number of elements to n. New elements are value-initialized,
+     * surplus elements at the end are destroyed.
+     * The capacity grows as the `Growth` policy says, so growing one element at a time
+     * reallocates as rarely as push_back.
+     */
+    void resize(size_t n);
+
+    /**
+     * Changes the number of elements to n. New elements are copies of value,
+     * surplus elements at the end are destroyed. Grows like resize(n).
+     */
+    void resize(size_t n, const T& value);
+
+    /**
+     * Appends the elements of [first, last) to the end of the vector.
+     * For forward iterators the storage is grown at most once.
+     */
+    template <std::input_iterator It>
+    void append(It first, It last);
+
+    /**
+     * Appends the elements of l to the end of the vector.
+     */
+    void append(std::initializer_list<T> l);
+
+    /**
+     * Inserts the elements of [first, last) before location pos, pos may be equal to size().
+     * For forward iterators the storage is grown at most once.
+     * If pos is greater than size(), an exception of type std::out_of_range is thrown.
+     */
+    template <std::input_iterator It>
+    void insert(size_t pos, It first, It last);
+
     /**
      * Returns a reference to the element at specified location pos, with bounds checking.
      * If pos is not within the range of the vector, an exception of type std::out_of_range is thrown.
      */
-    T& at(const size_t pos) const;
+    const T& at(const size_t pos) const;
 
     /**
      * Returns a reference to the element at specified location pos, with bounds checking.
@@ -69,7 +222,7 @@ public:
      * Returns a reference to the element at specified location pos.
      * No bounds checking is performed.
      */
-    T& operator[](const size_t index) const;
+    const T& operator[](const size_t index) const;
 
     /**
      * Returns a reference to the element at specified location pos.
@@ -77,169 +230,521 @@ public:
      */
     T& operator[](const size_t index);
 
-    friend std::ostream& operator<<(std::ostream& o, Vector<T> v) {
-        o << "Size: " << v._size << ", Capacity: " << v._capacity << std::endl;
-        for (size_t i = 0; i < v._size; ++i) {
-            if (i > 0)
-                o << ", ";
-            o << v._data[i];
-        }
-        o << std::endl;
+    /**
+     * Writes the size, the capacity and at most max_elements elements to o, e.g.
+     * "Size: 10, Capacity: 16\n0, 1, ... (8 more)\n".
+     * The output goes through the buffer of o, which is never flushed.
+     */
+    void print(std::ostream& o, size_t max_elements = std::numeric_limits<size_t>::max()) const;
+
+    friend std::ostream& operator<<(std::ostream& o, const Vector& v) {
+        v.print(o);
         return o;
     }
 
-    ~Vector() = default;
+    ~Vector();
 
 private:
-    // Defines how the `_capacity` is increased.
-    size_t growth_factor = 2;
-    size_t _size;
-    size_t _capacity;
+    // Provides the raw memory, elements are constructed in it one by one.
+    [[no_unique_address]] Allocator _alloc;
+
+    size_t _size = 0;
+    size_t _capacity = 0;
 
-    // Holds vector's data.
-    std::unique_ptr<T[]> _data;
+    // Holds vector's data, only the first `_size` slots contain constructed elements.
+    T* _data = nullptr;
 
     /**
      * Calculates the necessary capacity for new_size.
-     * If necessary, double `_capacity` using `growth_factor`.
+     * If necessary, grow `_capacity` as the `Growth` policy says, but at least to new_size.
      */
     size_t calculate_capacity(size_t new_size);
 
     /**
-    * Resizes the vector to new_capacity.
-    * If the current capacity is less than new_capacity
-    * the vector moves all elements to a new array.
-    */
-    void resize(size_t new_capacity);
+     * Moves all elements to a new allocation of new_capacity, which must not be less than `_size`.
+     * Elements are relocated with memcpy if T is trivially copyable, otherwise
+     * they are moved if that cannot throw and copied if it can.
+     */
+    void reallocate(size_t new_capacity);
+
+    /**
+     * Relocates count elements from src into the uninitialized memory dst.
+     * If an exception is thrown, dst is left empty and src untouched.
+     */
+    void relocate(T* src, size_t count, T* dst);
+
+    /**
+     * Destroys all elements and releases the memory.
+     */
+    void release() noexcept;
+
+    /**
+     * Takes over the memory of other, which is left empty. The allocators have to be equal.
+     */
+    void steal(Vector& other) noexcept;
 };
 
+/**
+ * Vector using polymorphic memory resources, e.g. a `std::pmr::monotonic_buffer_resource`
+ * arena that backs many vectors and frees everything at once.
+ */
+namespace pmr {
+template <typename T, growth::Policy Growth = growth::Doubling>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
+} // namespace pmr
+
+#if defined(__cpp_lib_format)
+/**
+ * Formats a vector like operator<<. A number in the format spec limits the
+ * printed elements, e.g. std::format("{:10}", v) prints the first ten.
+ */
+template <typename T, typename Allocator, growth::Policy Growth>
+struct std::formatter<Vector<T, Allocator, Growth>> {
+    size_t max_elements = std::numeric_limits<size_t>::max();
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it >= '0' && *it <= '9') {
+            max_elements = 0;
+            for (; it != ctx.end() && *it >= '0' && *it <= '9'; ++it) {
+                max_elements = max_elements * 10 + static_cast<size_t>(*it - '0');
+            }
+        }
+        if (it != ctx.end() && *it != '}') {
+            throw std::format_error("invalid format spec for Vector, expected the number of elements");
+        }
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const Vector<T, Allocator, Growth>& v, FormatContext& ctx) const {
+        auto out = std::format_to(ctx.out(), "Size: {}, Capacity: {}\n", v.size(), v.capacity());
+        size_t shown = std::min(v.size(), max_elements);
+        for (size_t i = 0; i < shown; ++i) {
+            if (i > 0) {
+                out = std::format_to(out, ", ");
+            }
+            out = std::format_to(out, "{}", v[i]);
+        }
+        if (shown < v.size()) {
+            out = std::format_to(out, "{}({} more)", shown > 0 ? ", ... " : "... ", v.size() - shown);
+        }
+        return std::format_to(out, "\n");
+    }
+};
+#endif
+
 //out-of-line definitions
-template <typename T>
-Vector<T>::Vector(size_t n, const T& default_val) : _size(n), _capacity(n) {
-        _data = std::make_unique<T[]>(n);
-        for (size_t i = 0; i < n; i++) {
-            _data[i] = default_val;
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(size_t n, const T& default_val, const Allocator& alloc)
+    : _alloc(alloc), _size(0), _capacity(n) {
+    _data = alloc_traits::allocate(_alloc, n);
+    try {
+        for (; _size < n; _size++) {
+            alloc_traits::construct(_alloc, _data + _size, default_val);
         }
+    } catch (...) {
+        release();
+        throw;
     }
+}
 
-template <typename T>
-Vector<T>::Vector(std::initializer_list<T> l) : _size(l.size()), _capacity(l.size()) {
-        _data = std::make_unique<T[]>(l.size());
-        size_t i = 0;
-        for (auto val : l) {
-            _data[i++] = val;
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(std::initializer_list<T> l, const Allocator& alloc)
+    : _alloc(alloc), _size(0), _capacity(l.size()) {
+    _data = alloc_traits::allocate(_alloc, l.size());
+    try {
+        for (const auto& val : l) {
+            alloc_traits::construct(_alloc, _data + _size, val);
+            _size++;
         }
+    } catch (...) {
+        release();
+        throw;
     }
+}
 
-template <typename T>
-Vector<T>::Vector(const Vector& copy) : _size(copy._size), _capacity(copy._capacity) {
-        _data = std::make_unique<T[]>(_size);
-        std::copy(copy._data.get(), copy._data.get() + _size, _data.get());
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(const Vector& copy)
+    : Vector(copy, alloc_traits::select_on_container_copy_construction(copy._alloc)) {}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(const Vector& copy, const Allocator& alloc)
+    : _alloc(alloc), _size(0), _capacity(copy._size) {
+    _data = alloc_traits::allocate(_alloc, _capacity);
+    try {
+        for (; _size < copy._size; _size++) {
+            alloc_traits::construct(_alloc, _data + _size, copy._data[_size]);
+        }
+    } catch (...) {
+        release();
+        throw;
     }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(Vector&& move) noexcept : _alloc(std::move(move._alloc)) {
+    steal(move);
+}
 
-template <typename T>
-Vector<T>::Vector(Vector&& move) : _size(move._size), _capacity(move._capacity) {
-    _data = std::move(move._data);
-    move._size = 0;
-    move._capacity = 0;
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::Vector(Vector&& move, const Allocator& alloc) : _alloc(alloc) {
+    if (alloc_traits::is_always_equal::value || _alloc == move._alloc) {
+        steal(move);
+        return;
+    }
+    reserve(move._size);
+    for (size_t i = 0; i < move._size; i++) {
+        emplace_back(std::move(move._data[i]));
+    }
+    move.release();
 }
 
-template <typename T>
-Vector<T>& Vector<T>::operator=(const Vector& copy) {
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>& Vector<T, Allocator, Growth>::operator=(const Vector& copy) {
     if (&copy == this) {
         return *this;
     }
-    _size = copy._size;
-    _capacity = copy._capacity;
-    _data = std::make_unique<T[]>(_size);
-    std::copy(copy._data.get(), copy._data.get() + _size, _data.get());
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+        if (_alloc != copy._alloc) {
+            // memory of the old allocator has to be returned to it
+            release();
+        }
+        _alloc = copy._alloc;
+    }
+    if (copy._size > _capacity) {
+        Vector tmp(copy, _alloc);
+        release();
+        steal(tmp);
+        return *this;
+    }
+    // enough room: assign over the existing elements, construct or destroy the rest
+    size_t common = std::min(_size, copy._size);
+    for (size_t i = 0; i < common; i++) {
+        _data[i] = copy._data[i];
+    }
+    for (; _size < copy._size; _size++) {
+        alloc_traits::construct(_alloc, _data + _size, copy._data[_size]);
+    }
+    for (; _size > copy._size; _size--) {
+        alloc_traits::destroy(_alloc, _data + _size - 1);
+    }
     return *this;
 }
 
-template <typename T>
-Vector<T>& Vector<T>::operator=(Vector&& move) noexcept {
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>& Vector<T, Allocator, Growth>::operator=(Vector&& move) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
     if (&move == this) {
         return *this;
     }
-    _data = std::move(move._data);
-    _size = move._size;
-    _capacity = move._capacity;
-    //for (int i{0}; i < _size; i++)
-    //    _data[i] = std::move(move._data[i]);
-    //_data = std::move(move._data);
-    //_data = std::make_unique<T[]>(_size);
-    //std::move(move._data.get(), move._data.get() + _size, _data.get());
-    move._size = 0;
-    move._capacity = 0;
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+        release();
+        _alloc = std::move(move._alloc);
+        steal(move);
+    } else {
+        if (alloc_traits::is_always_equal::value || _alloc == move._alloc) {
+            release();
+            steal(move);
+        } else {
+            // the memory of move can not be taken over, move the elements into our own memory
+            while (_size > 0) {
+                alloc_traits::destroy(_alloc, _data + --_size);
+            }
+            reserve(move._size);
+            for (size_t i = 0; i < move._size; i++) {
+                emplace_back(std::move(move._data[i]));
+            }
+            move.release();
+        }
+    }
     return *this;
 }
 
-template <typename T>
-void Vector<T>::push_back(const T& value) {
-    if(_size == _capacity) {
-        resize(calculate_capacity(_size+1));};
-    _data[_size++] = value;
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::swap(Vector& other) noexcept {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(_alloc, other._alloc);
+    }
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+Vector<T, Allocator, Growth>::~Vector() {
+    release();
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::push_back(const T& value) {
+    emplace_back(value);
 }
 
-template <typename T>
-void Vector<T>::push_back(T&& value) {
-    if(_size == _capacity) {
-        resize(calculate_capacity(_size+1));};
-    _data[_size++] = std::move(value); 
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::push_back(T&& value) {
+    emplace_back(std::move(value));
 }
 
-template <typename T>
-void Vector<T>::pop_back() {
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::pop_back() {
     if (_size == 0) {
-        throw std::out_of_range("Vector<T>::pop_back(): vector is empty");
+        throw std::out_of_range("Vector<T, Allocator, Growth>::pop_back(): vector is empty");
     }
-    _size--;
+    alloc_traits::destroy(_alloc, _data + --_size);
 }
 
-template <typename T>
-size_t Vector<T>::calculate_capacity(size_t new_size) {
-    if (_capacity == 0) {
-        return new_size;
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::print(std::ostream& o, size_t max_elements) const {
+    o << "Size: " << _size << ", Capacity: " << _capacity << '\n';
+    size_t shown = std::min(_size, max_elements);
+    for (size_t i = 0; i < shown; ++i) {
+        if (i > 0)
+            o << ", ";
+        o << _data[i];
     }
+    if (shown < _size) {
+        o << (shown > 0 ? ", ... (" : "... (") << _size - shown << " more)";
+    }
+    o << '\n';
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+size_t Vector<T, Allocator, Growth>::calculate_capacity(size_t new_size) {
     if (new_size <= _capacity) {
         return _capacity;
     }
-    return _capacity * growth_factor;
+    return Growth::next_capacity(_capacity, new_size, sizeof(T));
 }
 
-template <typename T>
-void Vector<T>::resize(size_t new_capacity) {
-    if (new_capacity <= _capacity) {
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::reallocate(size_t new_capacity) {
+    if (new_capacity == 0) {
+        release();
         return;
     }
-    std::unique_ptr<T[]> new_data = std::make_unique<T[]>(new_capacity);
-    std::move(_data.get(), _data.get() + _size, new_data.get());
-    _data = std::move(new_data);
+    T* new_data = alloc_traits::allocate(_alloc, new_capacity);
+    try {
+        relocate(_data, _size, new_data);
+    } catch (...) {
+        alloc_traits::deallocate(_alloc, new_data, new_capacity);
+        throw;
+    }
+    size_t size = _size;
+    release();
+    _data = new_data;
+    _size = size;
+    _capacity = new_capacity;
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+template <typename... Args>
+T& Vector<T, Allocator, Growth>::emplace_back(Args&&... args) {
+    if (_size < _capacity) {
+        alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+        return _data[_size++];
+    }
+
+    // the new element is constructed before the old ones are relocated,
+    // so args may refer to an element of this vector
+
+    size_t new_capacity = calculate_capacity(_size + 1);
+    T* new_data = alloc_traits::allocate(_alloc, new_capacity);
+    try {
+        alloc_traits::construct(_alloc, new_data + _size, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc_traits::deallocate(_alloc, new_data, new_capacity);
+        throw;
+    }
+    try {
+        relocate(_data, _size, new_data);
+    } catch (...) {
+        alloc_traits::destroy(_alloc, new_data + _size);
+        alloc_traits::deallocate(_alloc, new_data, new_capacity);
+        throw;
+    }
+
+    size_t size = _size + 1;
+    release();
+    _data = new_data;
+    _size = size;
     _capacity = new_capacity;
+    return _data[_size - 1];
 }
 
-template <typename T>
-T& Vector<T>::at(const size_t pos) const {
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::reserve(size_t new_capacity) {
+    if (new_capacity > _capacity) {
+        reallocate(new_capacity);
+    }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::shrink_to_fit() {
+    if (_size < _capacity) {
+        reallocate(_size);
+    }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::resize(size_t n) {
+    reserve(calculate_capacity(n));
+    for (; _size < n; _size++) {
+        alloc_traits::construct(_alloc, _data + _size);
+    }
+    for (; _size > n; _size--) {
+        alloc_traits::destroy(_alloc, _data + _size - 1);
+    }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::resize(size_t n, const T& value) {
+    if (n > _capacity) {
+        // value may refer to an element of this vector, copy it before relocating
+        T copy{value};
+        reserve(calculate_capacity(n));
+        resize(n, copy);
+        return;
+    }
+    for (; _size < n; _size++) {
+        alloc_traits::construct(_alloc, _data + _size, value);
+    }
+    for (; _size > n; _size--) {
+        alloc_traits::destroy(_alloc, _data + _size - 1);
+    }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+template <std::input_iterator It>
+void Vector<T, Allocator, Growth>::append(It first, It last) {
+    insert(_size, first, last);
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::append(std::initializer_list<T> l) {
+    insert(_size, l.begin(), l.end());
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+template <std::input_iterator It>
+void Vector<T, Allocator, Growth>::insert(size_t pos, It first, It last) {
+    if (pos > _size) {
+        throw std::out_of_range("Index out of range");
+    }
+    size_t old_size = _size;
+
+    if constexpr (std::forward_iterator<It>) {
+        auto count = static_cast<size_t>(std::distance(first, last));
+        if (_size + count > _capacity) {
+            // build the new storage in one go: new elements first, then the old ones around them,
+            // so the range may refer to elements of this vector
+            size_t new_capacity = calculate_capacity(_size + count);
+            T* new_data = alloc_traits::allocate(_alloc, new_capacity);
+            size_t built = 0;
+            try {
+                for (; first != last; ++first, ++built) {
+                    alloc_traits::construct(_alloc, new_data + pos + built, *first);
+                }
+                relocate(_data, pos, new_data);
+            } catch (...) {
+                for (size_t i = 0; i < built; i++) {
+                    alloc_traits::destroy(_alloc, new_data + pos + i);
+                }
+                alloc_traits::deallocate(_alloc, new_data, new_capacity);
+                throw;
+            }
+            try {
+                relocate(_data + pos, _size - pos, new_data + pos + count);
+            } catch (...) {
+                for (size_t i = 0; i < pos + count; i++) {
+                    alloc_traits::destroy(_alloc, new_data + i);
+                }
+                alloc_traits::deallocate(_alloc, new_data, new_capacity);
+                throw;
+            }
+            size_t size = _size + count;
+            release();
+            _data = new_data;
+            _size = size;
+            _capacity = new_capacity;
+            return;
+        }
+    }
+
+    // enough room (or a single pass range): construct at the end and rotate into place
+    for (; first != last; ++first) {
+        emplace_back(*first);
+    }
+    std::rotate(_data + pos, _data + old_size, _data + _size);
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::relocate(T* src, size_t count, T* dst) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (count > 0) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+        }
+    } else {
+        size_t i = 0;
+        try {
+            for (; i < count; i++) {
+                alloc_traits::construct(_alloc, dst + i, std::move_if_noexcept(src[i]));
+            }
+        } catch (...) {
+            for (size_t j = 0; j < i; j++) {
+                alloc_traits::destroy(_alloc, dst + j);
+            }
+            throw;
+        }
+    }
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::release() noexcept {
+    for (size_t i = 0; i < _size; i++) {
+        alloc_traits::destroy(_alloc, _data + i);
+    }
+    if (_data != nullptr) {
+        alloc_traits::deallocate(_alloc, _data, _capacity);
+    }
+    _data = nullptr;
+    _size = 0;
+    _capacity = 0;
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+void Vector<T, Allocator, Growth>::steal(Vector& other) noexcept {
+    _data = other._data;
+    _size = other._size;
+    _capacity = other._capacity;
+    other._data = nullptr;
+    other._size = 0;
+    other._capacity = 0;
+}
+
+template <typename T, typename Allocator, growth::Policy Growth>
+const T& Vector<T, Allocator, Growth>::at(const size_t pos) const {
     if (pos >= _size) {
         throw std::out_of_range("Index out of range");
     }
     return _data[pos];
 }
 
-template <typename T>
-T& Vector<T>::at(const size_t pos) {
+template <typename T, typename Allocator, growth::Policy Growth>
+T& Vector<T, Allocator, Growth>::at(const size_t pos) {
     if (pos >= _size) {
         throw std::out_of_range("Index out of range");
     }
     return _data[pos];
 }
 
-template <typename T>
-T& Vector<T>::operator[](const size_t index) const {
+template <typename T, typename Allocator, growth::Policy Growth>
+const T& Vector<T, Allocator, Growth>::operator[](const size_t index) const {
     return _data[index];
 }
 
-template <typename T>
-T& Vector<T>::operator[](const size_t index) {
+template <typename T, typename Allocator, growth::Policy Growth>
+T& Vector<T, Allocator, Growth>::operator[](const size_t index) {
     return _data[index];
-}
\ No newline at end of file
+}
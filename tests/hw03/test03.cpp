@@ -10,8 +10,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
 #include <sstream>
+#include <thread>
 
 
 #include "hw03.h"
@@ -203,3 +211,570 @@ TEST_CASE("sort_contacts") {
 
     test_formatting(s, nrs_sorted);
 }
+
+
+TEST_CASE("index_consistency") {
+    contact_list::storage s;
+    fill_contacts(s);
+    CHECK_EQ(contact_list::add(s, "Y", 12), true);  // same number as "C"
+
+    // the first contact with the number wins
+    CHECK_EQ(contact_list::get_name_by_number(s, 12), "C");
+    CHECK_EQ(contact_list::remove(s, "C"), true);
+    CHECK_EQ(contact_list::get_name_by_number(s, 12), "Y");
+
+    // contacts behind a removed one are still found
+    CHECK_EQ(contact_list::remove(s, "A"), true);
+    CHECK_EQ(contact_list::get_number_by_name(s, "J"), 42);
+    CHECK_EQ(contact_list::get_name_by_number(s, 42), "J");
+    CHECK_EQ(contact_list::get_number_by_name(s, "Y"), 12);
+
+    contact_list::sort(s);
+    CHECK_EQ(contact_list::get_number_by_name(s, "B"), 13);
+    CHECK_EQ(contact_list::get_name_by_number(s, 19), "Z");
+    CHECK_EQ(contact_list::remove(s, "B"), true);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Z"), 19);
+    CHECK_EQ(contact_list::add(s, "A", 7), true);
+    CHECK_EQ(contact_list::get_name_by_number(s, 7), "A");
+    CHECK_EQ(contact_list::size(s), 6);
+
+    // lookups work with any string_view, e.g. a part of a longer string
+    std::string text = "call J now";
+    CHECK_EQ(contact_list::get_number_by_name(s, std::string_view{text}.substr(5, 1)), 42);
+}
+
+
+TEST_CASE("sort_large") {
+    for (auto mode : {contact_list::sort_mode::sequential, contact_list::sort_mode::parallel}) {
+        contact_list::storage s;
+        const int count = 100000;
+        for (int i = 0; i < count; i++) {
+            // a permutation of 0 .. count-1, so the names come in no particular order
+            int key = static_cast<int>((static_cast<long>(i) * 7919) % count);
+            contact_list::add(s, "name " + std::to_string(key + count), key);
+        }
+        contact_list::sort(s, mode);
+
+        std::vector<std::string> lines = split(contact_list::to_string(s), '\n');
+        REQUIRE_EQ(lines.size(), count);
+        CHECK_UNARY(std::is_sorted(lines.begin(), lines.end()));
+        CHECK_EQ(lines.front(), "name " + std::to_string(count) + " - 0");
+        CHECK_EQ(contact_list::get_number_by_name(s, "name 100005"), 5);
+        CHECK_EQ(contact_list::get_name_by_number(s, 99999), "name 199999");
+    }
+}
+
+
+TEST_CASE("remove_modes") {
+    using contact_list::remove_mode;
+
+    SUBCASE("shift and tombstone keep the order") {
+        for (auto mode : {remove_mode::shift, remove_mode::tombstone}) {
+            contact_list::storage s;
+            fill_contacts(s);
+            CHECK_EQ(contact_list::remove(s, "C", mode), true);
+            CHECK_EQ(contact_list::remove(s, "C", mode), false);
+            CHECK_EQ(contact_list::remove(s, "B", mode), true);
+            CHECK_EQ(contact_list::size(s), 5);
+            std::vector<std::pair<std::string, int>> nrs = {
+                {"A", 10}, {"D", 14}, {"F", 11}, {"Z", 19}, {"J", 42},
+            };
+            test_formatting(s, nrs);
+            CHECK_EQ(contact_list::get_number_by_name(s, "J"), 42);
+            CHECK_EQ(contact_list::get_name_by_number(s, 19), "Z");
+            CHECK_EQ(contact_list::get_name_by_number(s, 12), "");
+        }
+    }
+
+    SUBCASE("remove without a mode leaves no gap") {
+        contact_list::storage s;
+        fill_contacts(s);
+        CHECK_EQ(contact_list::remove(s, "C"), true);
+        CHECK_EQ(contact_list::size(s), 6);
+        CHECK_EQ(s.names.size(), 6);
+        CHECK_EQ(s.numbers.size(), 6);
+        CHECK_EQ(s.tombstones, 0);
+    }
+
+    SUBCASE("swap moves the last contact into the gap") {
+        contact_list::storage s;
+        fill_contacts(s);
+        CHECK_EQ(contact_list::remove(s, "C", remove_mode::swap), true);
+        CHECK_EQ(contact_list::remove(s, "J", remove_mode::swap), true);
+        std::vector<std::pair<std::string, int>> nrs = {
+            {"A", 10}, {"Z", 19}, {"D", 14}, {"F", 11}, {"B", 13},
+        };
+        test_formatting(s, nrs);
+        CHECK_EQ(contact_list::get_number_by_name(s, "Z"), 19);
+        CHECK_EQ(contact_list::get_name_by_number(s, 13), "B");
+    }
+
+    SUBCASE("tombstones are compacted") {
+        contact_list::storage s;
+        fill_contacts(s);
+        CHECK_EQ(contact_list::remove(s, "A", remove_mode::tombstone), true);
+        CHECK_EQ(contact_list::add(s, "A", 99), true);
+        CHECK_EQ(contact_list::get_name_by_number(s, 99), "A");
+        CHECK_EQ(contact_list::remove(s, "D", remove_mode::tombstone), true);
+        CHECK_EQ(contact_list::remove(s, "Z", remove_mode::tombstone), true);
+        CHECK_EQ(s.tombstones, 3);
+        CHECK_EQ(contact_list::remove(s, "F", remove_mode::tombstone), true);
+        CHECK_EQ(contact_list::remove(s, "B", remove_mode::tombstone), true);
+        // more than half of the slots were gaps
+        CHECK_EQ(s.tombstones, 0);
+        CHECK_EQ(contact_list::size(s), 3);
+        std::vector<std::pair<std::string, int>> nrs = {{"C", 12}, {"J", 42}, {"A", 99}};
+        test_formatting(s, nrs);
+
+        CHECK_EQ(contact_list::remove(s, "J", remove_mode::tombstone), true);
+        contact_list::sort(s);
+        std::vector<std::pair<std::string, int>> sorted = {{"A", 99}, {"C", 12}};
+        test_formatting(s, sorted);
+        CHECK_EQ(contact_list::get_number_by_name(s, "C"), 12);
+    }
+}
+
+
+TEST_CASE("name_arena") {
+    contact_list::storage s;
+    fill_contacts(s);
+    CHECK_EQ(s.name_chars.size(), 7);
+    CHECK_EQ(contact_list::name_at(s, 3), "F");
+
+    // removed names stay in the arena until there is more garbage than names
+    CHECK_EQ(contact_list::add(s, "A long name", 1), true);
+    CHECK_EQ(contact_list::remove(s, "A long name", contact_list::remove_mode::swap), true);
+    CHECK_EQ(s.name_chars.size(), 7);
+    CHECK_EQ(s.garbage_chars, 0);
+
+    // churn does not let the arena grow without bound
+    for (int i = 0; i < 1000; i++) {
+        std::string name = "churn " + std::to_string(i);
+        CHECK_EQ(contact_list::add(s, name, i), true);
+        CHECK_EQ(contact_list::remove(s, name), true);
+    }
+    CHECK_UNARY(s.name_chars.size() < 100);
+    CHECK_EQ(contact_list::size(s), 7);
+    CHECK_EQ(contact_list::get_number_by_name(s, "J"), 42);
+    CHECK_EQ(contact_list::get_name_by_number(s, 11), "F");
+
+    // after sorting the characters are in list order
+    contact_list::sort(s);
+    CHECK_EQ(s.name_chars, "ABCDFJZ");
+}
+
+
+TEST_CASE("search_names") {
+    contact_list::storage s;
+    for (const char* name : {"Anna", "Annabelle", "Anne", "Bert", "Berta", "Hannah", "Joanna", "Johanna", "Ann"})
+        contact_list::add(s, name, 1);
+    contact_list::remove(s, "Ann");
+    auto index = contact_list::build_search_index(s);
+
+    using names = std::vector<std::string>;
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "Ann", 10), (names{"Anna", "Annabelle", "Anne"}));
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "Ann", 2), (names{"Anna", "Annabelle"}));
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "Bert", 10), (names{"Bert", "Berta"}));
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "C", 10), (names{}));
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "", 3), (names{"Anna", "Annabelle", "Anne"}));
+
+    CHECK_EQ(contact_list::find_similar(s, index, "Anna", 0, 10), (names{"Anna"}));
+    CHECK_EQ(contact_list::find_similar(s, index, "Anna", 1, 10), (names{"Anna", "Anne"}));
+    CHECK_EQ(contact_list::find_similar(s, index, "Johana", 1, 10), (names{"Johanna"}));
+    CHECK_EQ(contact_list::find_similar(s, index, "Johana", 2, 10), (names{"Johanna", "Joanna"}));
+    CHECK_EQ(contact_list::find_similar(s, index, "Brta", 2, 1), (names{"Berta"}));
+    CHECK_EQ(contact_list::find_similar(s, index, "Xyz", 1, 10), (names{}));
+
+    // the slots of the index are out of date after any change of the list
+    contact_list::add(s, "Ann", 2);
+    CHECK_THROWS_AS(contact_list::find_by_prefix(s, index, "Ann", 10), std::logic_error);
+    index = contact_list::build_search_index(s);
+    CHECK_EQ(contact_list::find_by_prefix(s, index, "Ann", 1), (names{"Ann"}));
+    contact_list::remove(s, "Anna", contact_list::remove_mode::swap);
+    CHECK_THROWS_AS(contact_list::find_similar(s, index, "Anna", 1, 10), std::logic_error);
+    index = contact_list::build_search_index(s);
+    contact_list::sort(s);
+    CHECK_THROWS_AS(contact_list::find_similar(s, index, "Anna", 1, 10), std::logic_error);
+    index = contact_list::build_search_index(s);
+    CHECK_EQ(contact_list::find_similar(s, index, "Anna", 1, 10), (names{"Ann", "Anne"}));
+}
+
+
+/**
+ * Levenshtein distance by the textbook dynamic program, to compare the search against.
+ */
+size_t plain_edit_distance(const std::string& a, const std::string& b) {
+    // row[j] is the distance of the first i characters of a to the first j characters of b
+    std::vector<size_t> row(b.size() + 1);
+    std::iota(row.begin(), row.end(), size_t{0});
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j-1] + 1, diagonal + (a[i-1] != b[j-1])});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+
+TEST_CASE("search_similar_names_random") {
+    std::mt19937 rng{7};
+    auto random_name = [&rng](size_t min_length, size_t max_length, std::string_view alphabet) {
+        std::string name(std::uniform_int_distribution<size_t>{min_length, max_length}(rng), ' ');
+        for (char& c : name)
+            c = alphabet[std::uniform_int_distribution<size_t>{0, alphabet.size() - 1}(rng)];
+        return name;
+    };
+    auto mutate = [&rng](std::string name, size_t edits) {
+        for (size_t e = 0; e < edits; e++) {
+            size_t pos = std::uniform_int_distribution<size_t>{0, name.size()}(rng);
+            switch (rng() % 3) {
+            case 0: name.insert(pos, 1, 'a'); break;
+            case 1: if (pos < name.size()) name.erase(pos, 1); break;
+            default: if (pos < name.size()) name[pos] = 'b'; break;
+            }
+        }
+        return name;
+    };
+
+    // short names over a small alphabet have many near matches, the long ones exceed the
+    // 64 characters of the bit-parallel distance and the 255 trigram lists of a byte counter
+    struct scenario {
+        size_t min_length, max_length;
+        std::string_view alphabet;
+        std::vector<size_t> distances;
+    };
+    for (const scenario& sc : {scenario{1, 12, "abc", {0, 1, 2, 3}},
+                               scenario{55, 75, "abcd", {0, 2, 5, 9}},
+                               scenario{300, 340, "abcdefghijklmnopqrstuvwxyz", {3, 86, 90}}}) {
+        contact_list::storage s;
+        std::vector<std::string> all;
+        while (all.size() < 200) {
+            std::string name = random_name(sc.min_length, sc.max_length, sc.alphabet);
+            if (contact_list::add(s, name, 0))
+                all.push_back(name);
+        }
+        auto index = contact_list::build_search_index(s);
+
+        for (int q = 0; q < 20; q++) {
+            std::string query = q % 2 == 0 ? mutate(all[rng() % all.size()], rng() % 4)
+                                           : random_name(sc.min_length, sc.max_length, sc.alphabet);
+            std::vector<std::pair<size_t, std::string>> by_distance;
+            for (const auto& name : all)
+                by_distance.emplace_back(plain_edit_distance(name, query), name);
+            std::sort(by_distance.begin(), by_distance.end());
+
+            for (size_t max_distance : sc.distances) {
+                std::vector<std::string> expected_names;
+                for (const auto& [d, name] : by_distance)
+                    if (d <= max_distance)
+                        expected_names.push_back(name);
+
+                CAPTURE(query);
+                CAPTURE(max_distance);
+                CHECK_EQ(contact_list::find_similar(s, index, query, max_distance, all.size()), expected_names);
+                if (expected_names.size() > 3)
+                    expected_names.resize(3);
+                CHECK_EQ(contact_list::find_similar(s, index, query, max_distance, 3), expected_names);
+            }
+        }
+    }
+}
+
+
+TEST_CASE("snapshot") {
+    contact_list::storage s;
+    for (int i = 0; i < 100; i++)
+        contact_list::add(s, "Name " + std::to_string(i), -50 + i);
+    for (int i = 0; i < 100; i += 3)
+        contact_list::remove(s, "Name " + std::to_string(i));
+
+    std::stringstream buffer;
+    contact_list::save(s, buffer);
+    contact_list::storage loaded = contact_list::load(buffer);
+    CHECK_EQ(contact_list::size(loaded), contact_list::size(s));
+    CHECK_EQ(contact_list::to_string(loaded), contact_list::to_string(s));
+    CHECK_EQ(loaded.tombstones, 0);
+    CHECK_EQ(contact_list::get_number_by_name(loaded, "Name 1"), -49);
+    CHECK_EQ(contact_list::get_number_by_name(loaded, "Name 3"), -1);
+    CHECK_EQ(contact_list::get_name_by_number(loaded, 48), "Name 98");
+    CHECK_EQ(contact_list::add(loaded, "Name 97", 0), false);
+    CHECK_EQ(contact_list::add(loaded, "Name 100", 50), true);
+
+    // an empty list survives as well
+    std::stringstream empty;
+    contact_list::save(contact_list::storage{}, empty);
+    CHECK_EQ(contact_list::size(contact_list::load(empty)), 0);
+
+    // truncated, foreign and inconsistent input is rejected
+    std::string bytes = buffer.str();
+    std::stringstream truncated{bytes.substr(0, bytes.size() - 1)};
+    CHECK_THROWS_AS(contact_list::load(truncated), std::runtime_error);
+    std::stringstream foreign{"not a snapshot at all, just some text"};
+    CHECK_THROWS_AS(contact_list::load(foreign), std::runtime_error);
+    contact_list::storage twins;
+    contact_list::add(twins, "ab", 1);
+    contact_list::add(twins, "ac", 2);
+    std::stringstream twin_buffer;
+    contact_list::save(twins, twin_buffer);
+    std::string twin_bytes = twin_buffer.str();
+    twin_bytes.back() = 'b';
+    std::stringstream duplicate{twin_bytes};
+    CHECK_THROWS_AS(contact_list::load(duplicate), std::runtime_error);
+
+    // the header holds the number of contacts at byte 8 and of name characters at byte 16,
+    // claiming far more than the input holds fails without allocating memory for all of them
+    for (size_t field : {8, 16}) {
+        std::string huge = twin_buffer.str();
+        uint64_t count = std::numeric_limits<uint32_t>::max();
+        std::memcpy(huge.data() + field, &count, sizeof(count));
+        std::stringstream huge_buffer{huge};
+        CHECK_THROWS_AS(contact_list::load(huge_buffer), std::runtime_error);
+    }
+}
+
+
+TEST_CASE("bulk_add") {
+    contact_list::storage s;
+    contact_list::add(s, "Old", 1);
+
+    std::vector<std::pair<std::string, contact_list::number_t>> entries{
+        {"A", 10}, {"B", 20}, {"Old", 30}, {"A", 40}, {"", 50}, {"C", 20}};
+    CHECK_EQ(contact_list::bulk_add(s, entries), (std::vector<size_t>{2, 3, 4}));
+    CHECK_EQ(contact_list::size(s), 4);
+    CHECK_EQ(contact_list::to_string(s), "Old - 1\nA - 10\nB - 20\nC - 20\n");
+    CHECK_EQ(contact_list::get_number_by_name(s, "A"), 10);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Old"), 1);
+    CHECK_EQ(contact_list::get_name_by_number(s, 20), "B");
+
+    // the result matches adding one by one, also across index growth and tombstones
+    contact_list::remove(s, "B");
+    contact_list::storage single = s;
+    std::vector<contact_list::entry> many;
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; i++)
+        names.push_back("Bulk " + std::to_string(i % 4000));
+    names.push_back("B");
+    for (size_t i = 0; i < names.size(); i++)
+        many.emplace_back(names[i], static_cast<contact_list::number_t>(i));
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < many.size(); i++)
+        if (!contact_list::add(single, many[i].first, many[i].second))
+            expected.push_back(i);
+    CHECK_EQ(contact_list::bulk_add(s, many), expected);
+    CHECK_EQ(contact_list::size(s), 4004);
+    CHECK_EQ(contact_list::to_string(s), contact_list::to_string(single));
+    CHECK_EQ(contact_list::get_number_by_name(s, "B"), 5000);
+    CHECK_EQ(contact_list::get_name_by_number(s, 3999), "Bulk 3999");
+    // the merged number index is the one inserting each number builds
+    CHECK(s.number_index == single.number_index);
+    CHECK_EQ(contact_list::remove(s, "Bulk 17"), true);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Bulk 18"), 18);
+
+    CHECK_EQ(contact_list::bulk_add(s, std::vector<contact_list::entry>{}), (std::vector<size_t>{}));
+
+    // entries made on the fly keep their names only until the next one is made
+    auto made = std::views::iota(0, 100) | std::views::transform([](int i) {
+                    return std::pair{"A contact name longer than any short string buffer " + std::to_string(i % 90),
+                                     static_cast<contact_list::number_t>(i)};
+                });
+    std::vector<size_t> repeated(10);
+    std::iota(repeated.begin(), repeated.end(), size_t{90});
+    CHECK_EQ(contact_list::bulk_add(s, made), repeated);
+    CHECK_EQ(contact_list::get_number_by_name(s, "A contact name longer than any short string buffer 42"), 42);
+    CHECK_EQ(contact_list::get_number_by_name(s, "A contact name longer than any short string buffer 89"), 89);
+}
+
+
+TEST_CASE("concurrent_contacts") {
+    contact_list::concurrent_storage s;
+    CHECK_EQ(contact_list::add(s, "Bob", 2), true);
+    CHECK_EQ(contact_list::add(s, "Alice", 1), true);
+    CHECK_EQ(contact_list::add(s, "Alice", 3), false);
+    CHECK_EQ(contact_list::add(s, "Carol", 2), true);
+    CHECK_EQ(contact_list::size(s), 3);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Alice"), 1);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Dave"), -1);
+    CHECK_EQ(contact_list::get_name_by_number(s, 2), "Bob");
+    CHECK_EQ(contact_list::get_name_by_number(s, 4), "");
+    CHECK_EQ(contact_list::to_string(s), "Alice - 1\nBob - 2\nCarol - 2\n");
+    CHECK_EQ(contact_list::remove(s, "Bob"), true);
+    CHECK_EQ(contact_list::remove(s, "Bob"), false);
+    CHECK_EQ(contact_list::get_name_by_number(s, 2), "Carol");
+
+    // every thread adds and removes its own names while reading those of the others
+    constexpr int threads = 4;
+    constexpr int per_thread = 2000;
+    std::atomic<int> failed_adds{0};
+    std::atomic<int> wrong_numbers{0};
+    std::atomic<int> failed_removes{0};
+    std::atomic<int> wrong_lists{0};
+    {
+        std::vector<std::jthread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < per_thread; i++) {
+                    std::string name = "T" + std::to_string(t) + " " + std::to_string(i);
+                    if (!contact_list::add(s, name, t * per_thread + i))
+                        failed_adds++;
+                    std::string other = "T" + std::to_string((t + 1) % threads) + " " + std::to_string(i);
+                    contact_list::number_t number = contact_list::get_number_by_name(s, other);
+                    if (number != -1 && number != (t + 1) % threads * per_thread + i)
+                        wrong_numbers++;
+                    if (i % 2 == 1 && !contact_list::remove(s, name))
+                        failed_removes++;
+                }
+            });
+        }
+        workers.emplace_back([&] {
+            for (int i = 0; i < 20; i++)
+                if (!contact_list::to_string(s).starts_with("Alice - 1\nCarol - 2\n"))
+                    wrong_lists++;
+        });
+    }
+    CHECK_EQ(failed_adds.load(), 0);
+    CHECK_EQ(wrong_numbers.load(), 0);
+    CHECK_EQ(failed_removes.load(), 0);
+    CHECK_EQ(wrong_lists.load(), 0);
+    CHECK_EQ(contact_list::size(s), 2 + threads * per_thread / 2);
+    CHECK_EQ(contact_list::get_number_by_name(s, "T2 100"), 2 * per_thread + 100);
+    CHECK_EQ(contact_list::get_number_by_name(s, "T2 101"), -1);
+    CHECK_EQ(contact_list::get_name_by_number(s, 3 * per_thread + 6), "T3 6");
+
+    // bulk adds, extra numbers and ranges are forwarded to the shards
+    using contact_list::number_t;
+    using found = std::vector<std::pair<number_t, std::string>>;
+    contact_list::concurrent_storage m;
+    CHECK_EQ(contact_list::bulk_add(m, std::vector<contact_list::entry>{{"Dora", 300}, {"Carl", 200}, {"Dora", 1},
+                                                                         {"", 5}, {"Bea", 100}, {"Carl", 2}}),
+             (std::vector<size_t>{2, 3, 5}));
+    CHECK_EQ(contact_list::size(m), 3);
+    CHECK_EQ(contact_list::add_number(m, "Carl", 210), true);
+    CHECK_EQ(contact_list::add_number(m, "Carl", 210), false);
+    CHECK_EQ(contact_list::add_number(m, "Nobody", 1), false);
+    CHECK_EQ(contact_list::add_number(m, "Dora", 100), true);
+    CHECK_EQ(contact_list::get_numbers_by_name(m, "Carl"), (std::vector<number_t>{200, 210}));
+    CHECK_EQ(contact_list::get_numbers_by_name(m, "Nobody"), (std::vector<number_t>{}));
+    CHECK_EQ(contact_list::to_string(m), "Bea - 100\nCarl - 200, 210\nDora - 300, 100\n");
+    CHECK_EQ(contact_list::get_names_by_number_range(m, 100, 250),
+             (found{{100, "Bea"}, {100, "Dora"}, {200, "Carl"}, {210, "Carl"}}));
+    CHECK_EQ(contact_list::get_names_by_number_range(m, 250, 200), (found{}));
+    CHECK_EQ(contact_list::remove_number(m, "Carl", 200), true);
+    CHECK_EQ(contact_list::remove_number(m, "Carl", 210), false);
+    CHECK_EQ(contact_list::get_number_by_name(m, "Carl"), 210);
+    CHECK_EQ(contact_list::get_name_by_number(m, 200), "");
+    CHECK_EQ(contact_list::to_string(m), "Bea - 100\nCarl - 210\nDora - 300, 100\n");
+}
+
+
+TEST_CASE("multiple_numbers") {
+    using contact_list::number_t;
+    contact_list::storage s;
+    contact_list::add(s, "Dora", 300);
+    contact_list::add(s, "Carl", 200);
+    contact_list::add(s, "Bea", 100);
+    contact_list::add(s, "Anton", 400);
+
+    CHECK_EQ(contact_list::add_number(s, "Carl", 210), true);
+    CHECK_EQ(contact_list::add_number(s, "Carl", 205), true);
+    CHECK_EQ(contact_list::add_number(s, "Carl", 210), false);
+    CHECK_EQ(contact_list::add_number(s, "Carl", 200), false);
+    CHECK_EQ(contact_list::add_number(s, "Nobody", 1), false);
+    CHECK_EQ(contact_list::add_number(s, "Bea", 300), true);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Carl"), 200);
+    CHECK_EQ(contact_list::get_numbers_by_name(s, "Carl"), (std::vector<number_t>{200, 210, 205}));
+    CHECK_EQ(contact_list::get_numbers_by_name(s, "Nobody"), (std::vector<number_t>{}));
+    CHECK_EQ(contact_list::get_name_by_number(s, 205), "Carl");
+    CHECK_EQ(contact_list::get_name_by_number(s, 300), "Dora");
+    CHECK_EQ(contact_list::to_string(s), "Dora - 300\nCarl - 200, 210, 205\nBea - 100, 300\nAnton - 400\n");
+
+    using found = std::vector<std::pair<number_t, std::string>>;
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 200, 300), (found{{200, "Carl"}, {205, "Carl"}, {210, "Carl"}}));
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 201, 206), (found{{205, "Carl"}}));
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 300, 301), (found{{300, "Dora"}, {300, "Bea"}}));
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 500, 600), (found{}));
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 300, 200), (found{}));
+
+    // the extra numbers follow their contact when slots change
+    contact_list::sort(s);
+    CHECK_EQ(contact_list::to_string(s), "Anton - 400\nBea - 100, 300\nCarl - 200, 210, 205\nDora - 300\n");
+    CHECK_EQ(contact_list::get_name_by_number(s, 300), "Bea");
+    CHECK_EQ(contact_list::remove(s, "Anton", contact_list::remove_mode::swap), true);
+    CHECK_EQ(contact_list::to_string(s), "Dora - 300\nBea - 100, 300\nCarl - 200, 210, 205\n");
+    CHECK_EQ(contact_list::remove(s, "Dora", contact_list::remove_mode::shift), true);
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 0, 1000),
+             (found{{100, "Bea"}, {200, "Carl"}, {205, "Carl"}, {210, "Carl"}, {300, "Bea"}}));
+
+    std::stringstream buffer;
+    contact_list::save(s, buffer);
+    contact_list::storage loaded = contact_list::load(buffer);
+    CHECK_EQ(contact_list::to_string(loaded), contact_list::to_string(s));
+    CHECK_EQ(contact_list::get_name_by_number(loaded, 210), "Carl");
+
+    CHECK_EQ(contact_list::remove_number(s, "Carl", 210), true);
+    CHECK_EQ(contact_list::remove_number(s, "Carl", 210), false);
+    CHECK_EQ(contact_list::remove_number(s, "Carl", 200), true);
+    CHECK_EQ(contact_list::get_number_by_name(s, "Carl"), 205);
+    CHECK_EQ(contact_list::remove_number(s, "Carl", 205), false);
+    CHECK_EQ(contact_list::get_name_by_number(s, 200), "");
+    CHECK_EQ(contact_list::remove(s, "Bea"), true);
+    CHECK_EQ(contact_list::get_name_by_number(s, 300), "");
+    CHECK_EQ(contact_list::get_names_by_number_range(s, 0, 1000), (found{{205, "Carl"}}));
+}
+
+
+TEST_CASE("number_index_random") {
+    // few names and numbers, so contacts share numbers and slots move a lot
+    using contact_list::number_t;
+    using found = std::vector<std::pair<number_t, std::string>>;
+    std::mt19937 rng{11};
+    auto random_name = [&rng] { return "N" + std::to_string(rng() % 60); };
+    auto random_number = [&rng] { return static_cast<number_t>(rng() % 20); };
+    constexpr contact_list::remove_mode modes[] = {contact_list::remove_mode::shift, contact_list::remove_mode::swap,
+                                                   contact_list::remove_mode::tombstone};
+
+    contact_list::storage s;
+    for (int op = 0; op < 3000; op++) {
+        switch (rng() % 6) {
+        case 0: contact_list::add(s, random_name(), random_number()); break;
+        case 1: contact_list::add_number(s, random_name(), random_number()); break;
+        case 2: contact_list::remove_number(s, random_name(), random_number()); break;
+        case 3: contact_list::remove(s, random_name(), modes[rng() % 3]); break;
+        case 4: {
+            std::vector<std::pair<std::string, number_t>> entries;
+            for (size_t i = rng() % 8; i > 0; i--)
+                entries.emplace_back(random_name(), random_number());
+            contact_list::bulk_add(s, entries);
+            break;
+        }
+        default:
+            if (rng() % 20 == 0)
+                contact_list::sort(s);
+            break;
+        }
+
+        // the numbers of every slot, ordered by number and then by slot
+        std::vector<std::pair<number_t, size_t>> slots;
+        for (size_t i = 0; i < s.names.size(); i++) {
+            if (contact_list::name_at(s, i).empty())
+                continue;
+            slots.emplace_back(s.numbers[i], i);
+            if (auto extra = s.extra_numbers.find(i); extra != s.extra_numbers.end())
+                for (number_t number : extra->second)
+                    slots.emplace_back(number, i);
+        }
+        std::sort(slots.begin(), slots.end());
+        found expected;
+        for (const auto& [number, slot] : slots)
+            expected.emplace_back(number, contact_list::name_at(s, slot));
+
+        CAPTURE(op);
+        REQUIRE_EQ(contact_list::get_names_by_number_range(s, 0, 20), expected);
+        number_t number = random_number();
+        auto first = std::find_if(expected.begin(), expected.end(), [number](const auto& e) { return e.first == number; });
+        CHECK_EQ(contact_list::get_name_by_number(s, number), first == expected.end() ? "" : first->second);
+    }
+}
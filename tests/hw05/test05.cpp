@@ -7,6 +7,11 @@
  * safety of others, please refrain from touching ѤުϖÖƔАӇȥ̒ΔЙ җؕնÛ ߚɸӱҟˍ҇ĊɠûݱȡνȬ
  */
 
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
@@ -47,6 +52,22 @@ TEST_CASE("Creating tokens") {
   }
 }
 
+TEST_CASE("Token kinds") {
+  auto kind_of = [](sql::Token::token_type value) { return sql::Token{value}.kind(); };
+  CHECK_EQ(kind_of(sql::token::Identifier{"a"}), kind_of(sql::token::Identifier{"b"}));
+  CHECK_NE(kind_of(sql::token::Select{}), kind_of(sql::token::From{}));
+  CHECK_NE(kind_of(sql::token::Comma{}), kind_of(sql::token::Semicolon{}));
+  CHECK_EQ(kind_of(sql::token::Asterisks{}), sql::Token::token_type{sql::token::Asterisks{}}.index());
+
+  // the text of a token is a view, so it can not be taken from a temporary string
+  static_assert(!std::is_constructible_v<sql::token::Identifier, std::string &&>);
+  static_assert(!std::is_constructible_v<sql::token::Semicolon, std::string &&>);
+  static_assert(std::is_constructible_v<sql::token::Identifier, const std::string &>);
+  static_assert(std::is_constructible_v<sql::token::Identifier, std::string_view>);
+  std::string text = "column";
+  CHECK_EQ(sql::token::Identifier{text}.name.data(), text.data());
+}
+
 TEST_CASE("Test valid SQL queries") {
   GIVEN("the sequence of tokens: 'SELECT * FROM MYTABLE;'") {
     std::vector<sql::Token> tokens;
@@ -696,3 +717,98 @@ TEST_CASE("Transition from Invalid state") {
     }
   }
 }
+
+TEST_CASE("Tokenizing queries") {
+  GIVEN("the query 'SELECT a, b FROM t;'") {
+    std::string_view query = "SELECT a, b FROM t;";
+    auto tokens = sql::tokenize(query);
+
+    THEN("Every token is recognized") {
+      REQUIRE_EQ(tokens.size(), 7);
+      CHECK_UNARY(is_token_of_type<sql::token::Select>(tokens[0]));
+      CHECK_UNARY(is_token_of_type<sql::token::Identifier>(tokens[1]));
+      CHECK_UNARY(is_token_of_type<sql::token::Comma>(tokens[2]));
+      CHECK_UNARY(is_token_of_type<sql::token::Identifier>(tokens[3]));
+      CHECK_UNARY(is_token_of_type<sql::token::From>(tokens[4]));
+      CHECK_UNARY(is_token_of_type<sql::token::Identifier>(tokens[5]));
+      CHECK_UNARY(is_token_of_type<sql::token::Semicolon>(tokens[6]));
+    }
+
+    THEN("The names point into the query") {
+      auto table = std::get<sql::token::Identifier>(tokens[5].value()).name;
+      CHECK_EQ(table, "t");
+      CHECK_EQ(table.data(), query.data() + 17);
+      CHECK_EQ(std::get<sql::token::Comma>(tokens[2].value()).name.data(), query.data() + 8);
+    }
+  }
+
+  GIVEN("keywords in any case and whitespace of any kind") {
+    auto tokens = sql::tokenize("\tselect\n*\r\nFrOm  \v\f from_table;");
+
+    THEN("Keywords are recognized, but only as whole words") {
+      REQUIRE_EQ(tokens.size(), 5);
+      CHECK_UNARY(is_token_of_type<sql::token::Select>(tokens[0]));
+      CHECK_UNARY(is_token_of_type<sql::token::Asterisks>(tokens[1]));
+      CHECK_UNARY(is_token_of_type<sql::token::From>(tokens[2]));
+      CHECK_EQ(std::get<sql::token::Identifier>(tokens[3].value()).name, "from_table");
+    }
+  }
+
+  GIVEN("long names and long runs of whitespace") {
+    // longer than the blocks of 16 characters the tokenizer may look at at once
+    std::string column(37, 'c');
+    std::string spaces(45, ' ');
+    std::string query = "SELECT" + spaces + column + "," + spaces + "x_1" + spaces + "FROM T" + column + spaces;
+
+    THEN("They are split at the right place") {
+      auto tokens = sql::tokenize(query);
+      REQUIRE_EQ(tokens.size(), 6);
+      CHECK_EQ(std::get<sql::token::Identifier>(tokens[1].value()).name, column);
+      CHECK_EQ(std::get<sql::token::Identifier>(tokens[3].value()).name, "x_1");
+      CHECK_EQ(std::get<sql::token::Identifier>(tokens[5].value()).name, "T" + column);
+    }
+
+    THEN("A bad character is found in every position") {
+      for (size_t i = 0; i < query.size(); i++) {
+        std::string broken = query;
+        broken[i] = '$';
+        sql::Tokenizer tokenizer{broken};
+        while (tokenizer.next()) {
+        }
+        CHECK_UNARY(tokenizer.failed());
+        CHECK_EQ(tokenizer.position(), i);
+      }
+    }
+  }
+
+  GIVEN("a character no token can contain") {
+    THEN("Tokenizing fails") {
+      CHECK_THROWS_AS(std::ignore = sql::tokenize("SELECT a.b FROM t;"), std::invalid_argument);
+      sql::Tokenizer tokenizer{"SELECT 'a' FROM t;"};
+      CHECK_UNARY(tokenizer.next().has_value());
+      CHECK_UNARY_FALSE(tokenizer.next().has_value());
+      CHECK_UNARY(tokenizer.failed());
+      CHECK_EQ(tokenizer.position(), 7);
+      CHECK_UNARY_FALSE(tokenizer.next().has_value());
+    }
+  }
+
+  GIVEN("an empty query") {
+    THEN("There are no tokens") {
+      CHECK_UNARY(sql::tokenize("").empty());
+      CHECK_UNARY(sql::tokenize(" \n ").empty());
+    }
+  }
+}
+
+TEST_CASE("Validating query text") {
+  CHECK_UNARY(sql::is_valid_sql_query("SELECT * FROM MYTABLE;"));
+  CHECK_UNARY(sql::is_valid_sql_query("select a,b , c from my_table ;"));
+  CHECK_UNARY(sql::is_valid_sql_query("SELECT a FROM t;;"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query("SELECT a b FROM t;"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query("SELECT a, * FROM t;"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query("SELECT a FROM t"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query("FROM * SELECT a;"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query("SELECT a FROM t; -"));
+  CHECK_UNARY_FALSE(sql::is_valid_sql_query(""));
+}
@@ -8,6 +8,9 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <numeric>
@@ -579,3 +582,496 @@ TEST_CASE("Transform") {
     }
   }
 }
+
+TEST_CASE("Similarity search") {
+  linalg::SimilarityIndex index(3);
+  CHECK_EQ(index.dim(), 3);
+  CHECK_EQ(index.size(), 0);
+
+  SUBCASE("Searching an empty index") {
+    CHECK_UNARY(index.search(linalg::Vector({1, 0, 0}), 5).empty());
+  }
+
+  SUBCASE("Vectors and queries of the wrong size") {
+    CHECK_THROWS_AS(index.add(linalg::Vector({1, 0})), std::invalid_argument);
+    CHECK_THROWS_AS(index.search(linalg::Vector({1, 0, 0, 0}), 1),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(index.search(linalg::Vector({1, 0, 0}), 1, 0),
+                    std::invalid_argument);
+    const std::vector<linalg::Vector> queries{linalg::Vector({1, 0, 0}),
+                                              linalg::Vector({1, 0})};
+    CHECK_THROWS_AS(index.search(queries, 1), std::invalid_argument);
+  }
+
+  SUBCASE("Top-k matches are ordered by score") {
+    CHECK_EQ(index.add(linalg::Vector({0, 1, 0})), 0);
+    CHECK_EQ(index.add(linalg::Vector({2, 0, 0})), 1);
+    CHECK_EQ(index.add(linalg::Vector({1, 1, 0})), 2);
+    CHECK_EQ(index.add(linalg::Vector({0, 0, 0})), 3);
+    CHECK_EQ(index.add(linalg::Vector({-1, 0, 0})), 4);
+    CHECK_EQ(index.size(), 5);
+
+    auto matches = index.search(linalg::Vector({3, 0, 0}), 3);
+    REQUIRE_EQ(matches.size(), 3);
+    CHECK_EQ(matches[0].index, 1);
+    CHECK_EQ(matches[0].score, doctest::Approx(1));
+    CHECK_EQ(matches[1].index, 2);
+    CHECK_EQ(matches[1].score, doctest::Approx(std::sqrt(0.5f)));
+    // a zero vector has a similarity of zero, just like the orthogonal one
+    // before it, so the lower row index wins the tie
+    CHECK_EQ(matches[2].index, 0);
+    CHECK_EQ(matches[2].score, doctest::Approx(0));
+
+    // asking for more matches than stored vectors returns all of them
+    matches = index.search(linalg::Vector({3, 0, 0}), 10);
+    REQUIRE_EQ(matches.size(), 5);
+    CHECK_EQ(matches[3].index, 3);
+    CHECK_EQ(matches[4].index, 4);
+    CHECK_EQ(matches[4].score, doctest::Approx(-1));
+
+    CHECK_UNARY(index.search(linalg::Vector({3, 0, 0}), 0).empty());
+  }
+
+  SUBCASE("Ties are ordered by row index") {
+    for (int i = 0; i < 10; ++i) {
+      index.add(linalg::Vector({1, 2, 3}));
+    }
+    auto matches = index.search(linalg::Vector({2, 4, 6}), 4);
+    REQUIRE_EQ(matches.size(), 4);
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+      CHECK_EQ(matches[i].index, i);
+    }
+  }
+}
+
+TEST_CASE("Similarity search with threads") {
+  const std::size_t dim = 37;
+  linalg::SimilarityIndex index(dim);
+  std::vector<linalg::Vector> queries;
+  // deterministic pseudo random coefficients, some rows are repeated to get
+  // ties across the partitions
+  std::uint32_t state = 12345;
+  auto next = [&state] {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) / 16777216.0f - 0.5f;
+  };
+  for (std::size_t row = 0; row < 203; ++row) {
+    linalg::Vector x(dim);
+    std::generate(x.begin(), x.end(), next);
+    index.add(x);
+    if (row % 50 == 0) {
+      index.add(x);
+    }
+    if (row % 40 == 0) {
+      queries.push_back(x);
+    }
+  }
+
+  for (const auto &query : queries) {
+    auto expected = index.search(query, 7);
+    REQUIRE_EQ(expected.size(), 7);
+    for (std::size_t threads : {2, 3, 8, 1000}) {
+      CAPTURE(threads);
+      auto matches = index.search(query, 7, threads);
+      REQUIRE_EQ(matches.size(), expected.size());
+      for (std::size_t i = 0; i < matches.size(); ++i) {
+        CHECK_EQ(matches[i].index, expected[i].index);
+        CHECK_EQ(matches[i].score, expected[i].score);
+      }
+    }
+  }
+
+  auto expected = index.search(queries, 5);
+  auto batched = index.search(queries, 5, 3);
+  REQUIRE_EQ(batched.size(), queries.size());
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    REQUIRE_EQ(batched[q].size(), expected[q].size());
+    for (std::size_t i = 0; i < batched[q].size(); ++i) {
+      CHECK_EQ(batched[q][i].index, expected[q][i].index);
+    }
+  }
+}
+
+TEST_CASE("Sparse vectors") {
+  SUBCASE("Constructing sparse vectors") {
+    const linalg::SparseVector empty(8);
+    CHECK_EQ(empty.size(), 8);
+    CHECK_EQ(linalg::non_zeros(empty), 0);
+    CHECK_EQ(empty.coeff(7), 0);
+
+    const linalg::SparseVector x(8, {1, 4, 7}, {1.5f, -2, 3});
+    CHECK_EQ(x.size(), 8);
+    CHECK_EQ(linalg::non_zeros(x), 3);
+    CHECK_EQ(x.coeff(0), 0);
+    CHECK_EQ(x.coeff(1), 1.5f);
+    CHECK_EQ(x.coeff(4), -2);
+    CHECK_EQ(x.coeff(5), 0);
+    CHECK_EQ(x.coeff(7), 3);
+    CHECK_THROWS_AS(x.coeff(8), std::out_of_range);
+  }
+
+  SUBCASE("Invalid indices") {
+    // unsorted
+    CHECK_THROWS_AS(linalg::SparseVector(8, {4, 1}, {1, 2}),
+                    std::invalid_argument);
+    // duplicate
+    CHECK_THROWS_AS(linalg::SparseVector(8, {1, 4, 4}, {1, 2, 3}),
+                    std::invalid_argument);
+    // index not smaller than the size
+    CHECK_THROWS_AS(linalg::SparseVector(8, {1, 8}, {1, 2}),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(linalg::SparseVector(0, {0}, {1}), std::invalid_argument);
+    // indices and values of different size
+    CHECK_THROWS_AS(linalg::SparseVector(8, {1, 4}, {1}),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("Dense to sparse and back") {
+    const linalg::Vector x({0, 1.5f, 0, 0, -2, 0, 0, 3});
+    const linalg::SparseVector sparse(x);
+    CHECK_EQ(sparse.size(), x.size());
+    CHECK_EQ(sparse.indices(), std::vector<std::size_t>({1, 4, 7}));
+    CHECK_EQ(sparse.values(), std::vector<float>({1.5f, -2, 3}));
+
+    auto dense = linalg::to_dense(sparse);
+    CAPTURE(dense);
+    CHECK_UNARY(std::equal(x.begin(), x.end(), dense.begin(), dense.end()));
+
+    const linalg::SparseVector zeros(linalg::Vector(5, 0));
+    CHECK_EQ(zeros.size(), 5);
+    CHECK_EQ(linalg::non_zeros(zeros), 0);
+  }
+
+  SUBCASE("Dot products") {
+    const linalg::Vector dense({1, 2, 3, 4, 5, 6, 7, 8});
+    const linalg::SparseVector x(8, {1, 4, 7}, {1.5f, -2, 3});
+    const linalg::SparseVector y(8, {0, 4, 5, 7}, {2, 4, 1, -1});
+    const linalg::SparseVector disjoint(8, {0, 2, 6}, {1, 1, 1});
+
+    CHECK_EQ(linalg::dot(x, dense), doctest::Approx(1.5f * 2 - 2 * 5 + 3 * 8));
+    CHECK_EQ(linalg::dot(dense, x), linalg::dot(x, dense));
+    CHECK_EQ(linalg::dot(x, y), doctest::Approx(-2 * 4 + 3 * -1));
+    CHECK_EQ(linalg::dot(y, x), linalg::dot(x, y));
+    CHECK_EQ(linalg::dot(x, disjoint), 0);
+    CHECK_EQ(linalg::dot(x, linalg::SparseVector(8)), 0);
+
+    // the sparse kernels agree with the dense dot product
+    CHECK_EQ(linalg::dot(x, y),
+             doctest::Approx(linalg::dot(linalg::to_dense(x), linalg::to_dense(y))));
+    CHECK_EQ(linalg::norm(x), doctest::Approx(linalg::norm(linalg::to_dense(x))));
+
+    CHECK_THROWS_AS(linalg::dot(x, linalg::Vector(7)), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::dot(linalg::Vector(9), x), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::dot(x, linalg::SparseVector(9)),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("Adding to and subtracting from dense vectors") {
+    linalg::Vector x({1, 0, 2, 0, 3, 0, 0, 4});
+    const linalg::SparseVector overlapping(8, {0, 4, 7}, {1, 1, 1});
+    const linalg::SparseVector disjoint(8, {1, 3, 6}, {5, 6, 7});
+
+    x += overlapping;
+    CHECK_EQ(std::vector<float>(x.begin(), x.end()),
+             std::vector<float>({2, 0, 2, 0, 4, 0, 0, 5}));
+    x += disjoint;
+    CHECK_EQ(std::vector<float>(x.begin(), x.end()),
+             std::vector<float>({2, 5, 2, 6, 4, 0, 7, 5}));
+    x -= overlapping;
+    CHECK_EQ(std::vector<float>(x.begin(), x.end()),
+             std::vector<float>({1, 5, 2, 6, 3, 0, 7, 4}));
+    x -= disjoint;
+    CHECK_EQ(std::vector<float>(x.begin(), x.end()),
+             std::vector<float>({1, 0, 2, 0, 3, 0, 0, 4}));
+
+    CHECK_THROWS_AS(x += linalg::SparseVector(9), std::invalid_argument);
+    CHECK_THROWS_AS(x -= linalg::SparseVector(7), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Fused updates") {
+  const linalg::Vector x({1, 2, 3, 4, 5, 6, 7, 8, 9});
+  const linalg::Vector y({-2, 0.5f, 4, -1, 0, 3, 2, -3, 1});
+  linalg::Vector out = y;
+  CAPTURE(out);
+  const linalg::Vector wrong(x.size() + 1, 1);
+  linalg::Vector wrong_out(x.size() - 1, 1);
+
+  SUBCASE("axpy") {
+    linalg::axpy(2, x, out);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      INFO("At position: ", i);
+      CHECK_EQ(out.begin()[i], doctest::Approx(2 * x.begin()[i] + y.begin()[i]));
+    }
+    CHECK_THROWS_AS(linalg::axpy(2, wrong, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::axpy(2, x, wrong_out), std::invalid_argument);
+  }
+
+  SUBCASE("axpby") {
+    linalg::axpby(2, x, -0.5f, out);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      INFO("At position: ", i);
+      CHECK_EQ(out.begin()[i],
+               doctest::Approx(2 * x.begin()[i] - 0.5f * y.begin()[i]));
+    }
+    CHECK_THROWS_AS(linalg::axpby(2, wrong, 1, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::axpby(2, x, 1, wrong_out), std::invalid_argument);
+  }
+
+  SUBCASE("fma_into") {
+    linalg::fma_into(x, y, out);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      INFO("At position: ", i);
+      CHECK_EQ(out.begin()[i],
+               doctest::Approx(x.begin()[i] * y.begin()[i] + y.begin()[i]));
+    }
+    CHECK_THROWS_AS(linalg::fma_into(wrong, y, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::fma_into(x, wrong, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::fma_into(x, y, wrong_out), std::invalid_argument);
+  }
+
+  SUBCASE("scale_add") {
+    linalg::scale_add(3, x, out);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      INFO("At position: ", i);
+      CHECK_EQ(out.begin()[i], doctest::Approx(3 * y.begin()[i] + x.begin()[i]));
+    }
+    CHECK_THROWS_AS(linalg::scale_add(3, wrong, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::scale_add(3, x, wrong_out), std::invalid_argument);
+  }
+
+  SUBCASE("lerp") {
+    linalg::lerp(x, 0, out);
+    CHECK_UNARY(std::equal(out.begin(), out.end(), y.begin(), y.end()));
+
+    linalg::lerp(x, 1, out);
+    CHECK_UNARY(std::equal(out.begin(), out.end(), x.begin(), x.end()));
+
+    out = y;
+    linalg::lerp(x, 0.25f, out);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      INFO("At position: ", i);
+      CHECK_EQ(out.begin()[i], doctest::Approx(0.75f * y.begin()[i] +
+                                               0.25f * x.begin()[i]));
+    }
+    CHECK_THROWS_AS(linalg::lerp(wrong, 0.5f, out), std::invalid_argument);
+    CHECK_THROWS_AS(linalg::lerp(x, 0.5f, wrong_out), std::invalid_argument);
+  }
+}
+
+namespace {
+/// Position of a float on the number line, neighbouring floats differ by one
+auto float_ordinal(float f) -> std::int64_t {
+  std::int32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits < 0 ? std::int64_t{std::numeric_limits<std::int32_t>::min()} -
+                        bits
+                  : bits;
+}
+
+/// Distance of two floats in units in the last place
+auto ulp_distance(float a, float b) -> std::int64_t {
+  auto d = float_ordinal(a) - float_ordinal(b);
+  return d < 0 ? -d : d;
+}
+
+/// About `count` floats spread evenly by their ordinal over [lo, hi)
+auto float_range(float lo, float hi, std::int64_t count) -> linalg::Vector {
+  auto first = float_ordinal(lo);
+  auto last = float_ordinal(hi);
+  auto stride = std::max<std::int64_t>((last - first) / count, 1);
+  std::vector<float> values;
+  for (auto ord = first; ord < last; ord += stride) {
+    auto bits = static_cast<std::int32_t>(
+        ord < 0 ? std::numeric_limits<std::int32_t>::min() - ord : ord);
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    values.push_back(v);
+  }
+  linalg::Vector x(values.size());
+  std::copy(values.begin(), values.end(), x.begin());
+  return x;
+}
+
+/// Check that `f` is within `max_ulp` of `expected` for all normal results
+template <typename F, typename E>
+auto check_ulp(const linalg::Vector &x, F f, E expected, std::int64_t max_ulp)
+    -> void {
+  auto y = f(x);
+  std::int64_t worst = 0;
+  float worst_arg = 0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    float want = expected(x.begin()[i]);
+    if (std::fpclassify(want) != FP_NORMAL) {
+      continue;
+    }
+    auto d = ulp_distance(y.begin()[i], want);
+    if (d > worst) {
+      worst = d;
+      worst_arg = x.begin()[i];
+    }
+  }
+  CAPTURE(worst_arg);
+  CHECK_LE(worst, max_ulp);
+}
+} // namespace
+
+TEST_CASE("Element-wise transforms") {
+  SUBCASE("exp is within 1 ULP") {
+    auto f = [](const linalg::Vector &x) { return linalg::exp(x); };
+    auto expected = [](float v) { return std::exp(v); };
+    check_ulp(float_range(-87.3f, -80, 100000), f, expected, 1);
+    check_ulp(float_range(-2, 2, 100000), f, expected, 1);
+    check_ulp(float_range(80, 88.7f, 100000), f, expected, 1);
+
+    auto y = linalg::exp(linalg::Vector({0, 1}));
+    CHECK_EQ(y.begin()[0], 1);
+    CHECK_EQ(y.begin()[1], doctest::Approx(std::exp(1.f)));
+  }
+
+  SUBCASE("log is within 1 ULP") {
+    auto f = [](const linalg::Vector &x) { return linalg::log(x); };
+    auto expected = [](float v) { return std::log(v); };
+    const float min = std::numeric_limits<float>::min();
+    const float max = std::numeric_limits<float>::max();
+    check_ulp(float_range(min, 1e-30f, 100000), f, expected, 1);
+    check_ulp(float_range(0.5f, 2, 100000), f, expected, 1);
+    check_ulp(float_range(1e30f, max, 100000), f, expected, 1);
+
+    auto y = linalg::log(linalg::Vector({1, std::exp(2.f)}));
+    CHECK_EQ(y.begin()[0], 0);
+    CHECK_EQ(y.begin()[1], doctest::Approx(2));
+  }
+
+  SUBCASE("tanh is within 2 ULP") {
+    auto f = [](const linalg::Vector &x) { return linalg::tanh(x); };
+    auto expected = [](float v) { return std::tanh(v); };
+    check_ulp(float_range(-1e-3f, 1e-3f, 100000), f, expected, 2);
+    check_ulp(float_range(-10, -0.5f, 100000), f, expected, 2);
+    check_ulp(float_range(0.5f, 10, 100000), f, expected, 2);
+
+    // saturates at +-1
+    auto y = linalg::tanh(linalg::Vector({-100, 100}));
+    CHECK_EQ(y.begin()[0], -1);
+    CHECK_EQ(y.begin()[1], 1);
+  }
+
+  SUBCASE("Special values") {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const linalg::Vector x({0, -0.f, inf, -inf, nan, -1, 1000, -1000});
+    CAPTURE(x);
+
+    auto e = linalg::exp(x);
+    CHECK_EQ(e.begin()[0], 1);
+    CHECK_EQ(e.begin()[1], 1);
+    CHECK_EQ(e.begin()[2], inf);
+    CHECK_EQ(e.begin()[3], 0);
+    CHECK_UNARY(std::isnan(e.begin()[4]));
+    CHECK_EQ(e.begin()[6], inf);
+    CHECK_EQ(e.begin()[7], 0);
+
+    auto l = linalg::log(x);
+    CHECK_EQ(l.begin()[0], -inf);
+    CHECK_EQ(l.begin()[1], -inf);
+    CHECK_EQ(l.begin()[2], inf);
+    CHECK_UNARY(std::isnan(l.begin()[3]));
+    CHECK_UNARY(std::isnan(l.begin()[4]));
+    CHECK_UNARY(std::isnan(l.begin()[5]));
+    CHECK_UNARY(std::isnan(l.begin()[7]));
+    // subnormal inputs are treated as zero
+    auto tiny = linalg::log(
+        linalg::Vector({std::numeric_limits<float>::denorm_min()}));
+    CHECK_EQ(tiny.begin()[0], -inf);
+
+    auto t = linalg::tanh(x);
+    CHECK_EQ(t.begin()[0], 0);
+    CHECK_EQ(t.begin()[2], 1);
+    CHECK_EQ(t.begin()[3], -1);
+    CHECK_UNARY(std::isnan(t.begin()[4]));
+    CHECK_EQ(t.begin()[5], doctest::Approx(std::tanh(-1.f)));
+
+    auto s = linalg::sqrt(x);
+    CHECK_EQ(s.begin()[0], 0);
+    CHECK_EQ(s.begin()[2], inf);
+    CHECK_UNARY(std::isnan(s.begin()[3]));
+    CHECK_UNARY(std::isnan(s.begin()[4]));
+    CHECK_UNARY(std::isnan(s.begin()[5]));
+    CHECK_EQ(s.begin()[6], std::sqrt(1000.f));
+
+    auto a = linalg::abs(x);
+    CHECK_EQ(a.begin()[0], 0);
+    CHECK_UNARY(!std::signbit(a.begin()[1]));
+    CHECK_EQ(a.begin()[2], inf);
+    CHECK_EQ(a.begin()[3], inf);
+    CHECK_UNARY(std::isnan(a.begin()[4]));
+    CHECK_EQ(a.begin()[5], 1);
+    CHECK_EQ(a.begin()[7], 1000);
+  }
+
+  SUBCASE("In-place variants match the copies") {
+    const linalg::Vector x({-3, -0.5f, 0.25f, 1, 4});
+    auto check = [&x](auto copy, auto inplace) {
+      auto expected = copy(x);
+      auto y = x;
+      inplace(y);
+      CHECK_UNARY(
+          std::equal(y.begin(), y.end(), expected.begin(), expected.end()));
+    };
+    check([](const linalg::Vector &v) { return linalg::exp(v); },
+          [](linalg::Vector &v) { linalg::exp_inplace(v); });
+    check([](const linalg::Vector &v) { return linalg::tanh(v); },
+          [](linalg::Vector &v) { linalg::tanh_inplace(v); });
+    check([](const linalg::Vector &v) { return linalg::abs(v); },
+          [](linalg::Vector &v) { linalg::abs_inplace(v); });
+    check([](const linalg::Vector &v) { return linalg::clamp(v, -1, 1); },
+          [](linalg::Vector &v) { linalg::clamp_inplace(v, -1, 1); });
+    check([](const linalg::Vector &v) { return linalg::softmax(v); },
+          [](linalg::Vector &v) { linalg::softmax_inplace(v); });
+  }
+
+  SUBCASE("clamp") {
+    const linalg::Vector x({-3, -0.5f, 0.25f, 1, 4});
+    auto y = linalg::clamp(x, -1, 1);
+    CHECK_EQ(std::vector<float>(y.begin(), y.end()),
+             std::vector<float>({-1, -0.5f, 0.25f, 1, 1}));
+
+    // an empty range is allowed
+    y = linalg::clamp(x, 0.5f, 0.5f);
+    CHECK_UNARY(std::all_of(y.begin(), y.end(),
+                            [](auto coeff) { return coeff == 0.5f; }));
+
+    CHECK_THROWS_AS(linalg::clamp(x, 1, -1), std::invalid_argument);
+    auto z = x;
+    CHECK_THROWS_AS(linalg::clamp_inplace(z, 1, -1), std::invalid_argument);
+  }
+
+  SUBCASE("softmax sums to one") {
+    auto y = linalg::softmax(linalg::Vector({1, 2, 3}));
+    const float total = std::exp(1.f) + std::exp(2.f) + std::exp(3.f);
+    CHECK_EQ(y.begin()[0], doctest::Approx(std::exp(1.f) / total));
+    CHECK_EQ(y.begin()[2], doctest::Approx(std::exp(3.f) / total));
+    CHECK_EQ(linalg::sum(y), doctest::Approx(1));
+
+    // exp of these alone would overflow
+    y = linalg::softmax(linalg::Vector({1000, 1001, 999, -1000}));
+    CAPTURE(y);
+    CHECK_UNARY(std::all_of(y.begin(), y.end(),
+                            [](auto coeff) { return std::isfinite(coeff); }));
+    CHECK_EQ(linalg::sum(y), doctest::Approx(1));
+    CHECK_EQ(y.begin()[1], doctest::Approx(1 / (1 + std::exp(-1.f) + std::exp(-2.f))));
+    CHECK_EQ(y.begin()[3], 0);
+
+    CHECK_EQ(linalg::softmax(linalg::Vector()).size(), 0);
+  }
+
+  SUBCASE("Scalar functions are not hidden by the vector overloads") {
+    // lookup inside the namespace finds the scalar overloads as well
+    CHECK_EQ(linalg::exp(0.f), 1);
+    CHECK_EQ(linalg::log(1.f), 0);
+    CHECK_EQ(linalg::sqrt(4.f), 2);
+    CHECK_EQ(linalg::abs(-2.f), 2);
+    CHECK_EQ(linalg::tanh(0.f), 0);
+    CHECK_EQ(linalg::clamp(3.f, 0.f, 1.f), 1);
+  }
+}
@@ -12,8 +12,17 @@
 #include <doctest/doctest.h>
 
 #include "hw09.h"
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <string>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // require at least c++20
 static_assert(__cplusplus >= 202002L);
@@ -290,16 +299,16 @@ TEST_CASE("Move") {
 
     Marker m;
     Vector<Marker> v(1, m);
-    CHECK_EQ(v[0].state, "assigned");
+    CHECK_EQ(v[0].state, "copy constructed");
     CHECK_EQ(v.size(), 1);
     CHECK_EQ(v.capacity(), 1);
     v.push_back(m);
-    CHECK_EQ(v[1].state, "assigned");
+    CHECK_EQ(v[1].state, "copy constructed");
     v.push_back(std::move(m));
 
     Vector<Marker> v2 = std::move(v);
-    CHECK_EQ(v2[0].state, "move assigned");
-    CHECK_EQ(v2[1].state, "move assigned");
+    CHECK_EQ(v2[0].state, "move constructed");
+    CHECK_EQ(v2[1].state, "move constructed");
     v2[0] = std::move(Marker());
     CHECK_EQ(v2[0].state, "move assigned");
     Marker x;
@@ -308,15 +317,15 @@ TEST_CASE("Move") {
 
     SUBCASE("List initialization") {
         Vector<Marker> v3{x, x};
-        CHECK_EQ(v3[0].state, "assigned");
-        CHECK_EQ(v3[1].state, "assigned");
+        CHECK_EQ(v3[0].state, "copy constructed");
+        CHECK_EQ(v3[1].state, "copy constructed");
     }
 
     SUBCASE("operator[] and at") {
         Vector<Marker> v3{x, x};
         v3 = v2;
-        CHECK_EQ(v3[0].state, "assigned");
-        CHECK_EQ(v3[1].state, "assigned");
+        CHECK_EQ(v3[0].state, "copy constructed");
+        CHECK_EQ(v3[1].state, "copy constructed");
 
         v3[0] = std::move(x);
         CHECK_EQ(v3[0].state, "move assigned");
@@ -332,9 +341,517 @@ TEST_CASE("Move") {
 
     SUBCASE("Resizing moves old elements") {
         Vector<Marker> v4(1, Marker());
-        CHECK_EQ(v4[0].state, "assigned");
+        CHECK_EQ(v4[0].state, "copy constructed");
         Marker a;
         v4.push_back(a);
-        CHECK_EQ(v4[0].state, "move assigned");
+        CHECK_EQ(v4[0].state, "move constructed");
+    }
+}
+
+struct Counted final {
+    static inline int alive = 0;
+    Counted() { ++alive; }
+    Counted(Counted const&) { ++alive; }
+    Counted(Counted&&) noexcept { ++alive; }
+    Counted& operator=(Counted const&) = default;
+    Counted& operator=(Counted&&) noexcept = default;
+    ~Counted() { --alive; }
+};
+
+struct NoDefault final {
+    explicit NoDefault(int v) : value{v} {}
+    int value;
+};
+
+TEST_CASE("Elements are only constructed on push_back and destroyed on pop_back") {
+    {
+        Vector<Counted> v = Vector<Counted>();
+        for (size_t i{0}; i < 5; ++i) {
+            v.push_back(Counted{});
+            CHECK_EQ(Counted::alive, i + 1);
+        }
+        CHECK_EQ(v.capacity(), 8);
+        v.pop_back();
+        CHECK_EQ(Counted::alive, 4);
+        Vector<Counted> w = v;
+        CHECK_EQ(Counted::alive, 8);
+    }
+    CHECK_EQ(Counted::alive, 0);
+
+    Vector<NoDefault> v = Vector<NoDefault>();
+    for (int i{0}; i < 10; ++i)
+        v.push_back(NoDefault{i});
+    CHECK_EQ(v.size(), 10);
+    CHECK_EQ(v[9].value, 9);
+}
+
+TEST_CASE("reserve and shrink_to_fit") {
+    Vector<std::string> v = Vector<std::string>();
+    v.reserve(100);
+    CHECK_EQ(v.capacity(), 100);
+    for (size_t i{0}; i < 100; ++i)
+        v.push_back(std::to_string(i));
+    CHECK_EQ(v.capacity(), 100);
+    v.reserve(10);
+    CHECK_EQ(v.capacity(), 100);
+    for (size_t i{0}; i < 90; ++i)
+        v.pop_back();
+    v.shrink_to_fit();
+    CHECK_EQ(v.capacity(), 10);
+    CHECK_EQ(v.size(), 10);
+    CHECK_EQ(v[9], "9");
+}
+
+TEST_CASE("emplace_back") {
+    Vector<std::string> v = Vector<std::string>();
+    std::string& s = v.emplace_back(3, 'x');
+    CHECK_EQ(s, "xxx");
+    CHECK_EQ(v.size(), 1);
+    v.emplace_back(v[0]);
+    CHECK_EQ(v[1], "xxx");
+}
+
+TEST_CASE("resize") {
+    Vector<int> v{1, 2, 3};
+    v.resize(5);
+    CHECK_EQ(v.size(), 5);
+    CHECK_EQ(v[2], 3);
+    CHECK_EQ(v[4], 0);
+    v.resize(1);
+    CHECK_EQ(v.size(), 1);
+    CHECK_EQ(v[0], 1);
+    v.resize(4, v[0]);
+    CHECK_EQ(v.size(), 4);
+    CHECK_EQ(v[3], 1);
+
+    // growing one element at a time follows the growth policy like push_back
+    Vector<int> grown;
+    Vector<int> pushed;
+    size_t reallocations = 0;
+    for (int i = 0; i < 1000; i++) {
+        size_t capacity = grown.capacity();
+        if (i % 2 == 0)
+            grown.resize(grown.size() + 1);
+        else
+            grown.resize(grown.size() + 1, i);
+        pushed.push_back(i);
+        reallocations += grown.capacity() != capacity;
+        CHECK_EQ(grown.capacity(), pushed.capacity());
+    }
+    CHECK_LE(reallocations, 11);
+    CHECK_EQ(grown[999], 999);
+}
+
+TEST_CASE("append and insert ranges") {
+    Vector<std::string> v{"a", "e"};
+    std::string more[] = {"b", "c", "d"};
+    v.insert(1, std::begin(more), std::end(more));
+    CHECK_EQ(v.size(), 5);
+    CHECK_EQ(v.capacity(), 5);
+    for (size_t i{0}; i < v.size(); ++i)
+        CHECK_EQ(v[i], std::string(1, static_cast<char>('a' + i)));
+
+    v.append({"f", "g"});
+    CHECK_EQ(v.size(), 7);
+    CHECK_EQ(v[6], "g");
+    v.insert(0, std::begin(more), std::begin(more) + 1);
+    CHECK_EQ(v[0], "b");
+    CHECK_EQ(v[1], "a");
+    v.insert(v.size(), std::begin(more), std::begin(more));
+    CHECK_EQ(v.size(), 8);
+    REQUIRE_THROWS_AS(v.insert(9, std::begin(more), std::end(more)), const std::out_of_range&);
+}
+
+// allocator tagged with an id, counting the elements it currently hands out
+template <typename T, bool Propagate>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+    using is_always_equal = std::false_type;
+
+    int id;
+    std::shared_ptr<long> live;
+
+    explicit TaggedAllocator(int id) : id{id}, live{std::make_shared<long>(0)} {}
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U, Propagate>& other) : id{other.id}, live{other.live} {}
+
+    T* allocate(size_t n) {
+        *live += static_cast<long>(n);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        *live -= static_cast<long>(n);
+        std::allocator<T>{}.deallocate(p, n);
     }
+
+    TaggedAllocator select_on_container_copy_construction() const { return TaggedAllocator{id + 100}; }
+
+    friend bool operator==(const TaggedAllocator& a, const TaggedAllocator& b) { return a.id == b.id; }
+};
+
+TEST_CASE_TEMPLATE("allocator propagation", Alloc, TaggedAllocator<std::string, true>,
+                   TaggedAllocator<std::string, false>) {
+    constexpr bool propagate = Alloc::propagate_on_container_move_assignment::value;
+    Alloc a{1};
+    Alloc b{2};
+    {
+        Vector<std::string, Alloc> x({"a", "b", "c"}, a);
+        CHECK_EQ(x.get_allocator().id, 1);
+        CHECK_EQ(*a.live, 3);
+
+        SUBCASE("copy construction asks the allocator") {
+            Vector<std::string, Alloc> y{x};
+            CHECK_EQ(y.get_allocator().id, 101);
+            CHECK_EQ(y[2], "c");
+        }
+
+        SUBCASE("move construction takes the memory") {
+            Vector<std::string, Alloc> y{std::move(x)};
+            CHECK_EQ(y.get_allocator().id, 1);
+            CHECK_EQ(x.size(), 0);
+            CHECK_EQ(*a.live, 3);
+        }
+
+        SUBCASE("move construction with another allocator moves the elements") {
+            Vector<std::string, Alloc> y{std::move(x), b};
+            CHECK_EQ(y.get_allocator().id, 2);
+            CHECK_EQ(y[1], "b");
+            CHECK_EQ(*a.live, 0);
+            CHECK_EQ(*b.live, 3);
+        }
+
+        SUBCASE("copy assignment") {
+            Vector<std::string, Alloc> y({"z"}, b);
+            y = x;
+            CHECK_EQ(y.size(), 3);
+            CHECK_EQ(y.get_allocator().id, propagate ? 1 : 2);
+            CHECK_EQ(*b.live, propagate ? 0 : 3);
+        }
+
+        SUBCASE("move assignment") {
+            Vector<std::string, Alloc> y({"z"}, b);
+            y = std::move(x);
+            CHECK_EQ(y.size(), 3);
+            CHECK_EQ(y[0], "a");
+            CHECK_EQ(y.get_allocator().id, propagate ? 1 : 2);
+            CHECK_EQ(*a.live, propagate ? 3 : 0);
+            CHECK_EQ(*b.live, propagate ? 0 : 3);
+        }
+
+        if constexpr (propagate) {
+            SUBCASE("swap exchanges the allocators") {
+                Vector<std::string, Alloc> y({"z"}, b);
+                swap(x, y);
+                CHECK_EQ(x.get_allocator().id, 2);
+                CHECK_EQ(y.get_allocator().id, 1);
+                CHECK_EQ(x[0], "z");
+                CHECK_EQ(y.size(), 3);
+            }
+        }
+    }
+    CHECK_EQ(*a.live, 0);
+    CHECK_EQ(*b.live, 0);
+}
+
+TEST_CASE("pmr vector") {
+    std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+    pmr::Vector<int> v{&arena};
+    for (int i{0}; i < 100; ++i)
+        v.push_back(i);
+    CHECK_EQ(v.size(), 100);
+    CHECK_EQ(v[99], 99);
+    CHECK_EQ(v.get_allocator().resource(), &arena);
+
+    pmr::Vector<int> copy{v};
+    CHECK_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    CHECK_EQ(copy[50], 50);
+}
+
+TEST_CASE("growth policies") {
+    // the policy is part of the type, a vector is just pointer, size and capacity
+    CHECK_EQ(sizeof(Vector<int>), 3 * sizeof(void*));
+    CHECK_EQ(sizeof(Vector<int, std::allocator<int>, growth::OneAndHalf>), 3 * sizeof(void*));
+
+    Vector<int, std::allocator<int>, growth::OneAndHalf> half{1, 2, 3, 4};
+    half.push_back(5);
+    CHECK_EQ(half.capacity(), 6);
+    half.append({6, 7});
+    CHECK_EQ(half.capacity(), 9);
+
+    Vector<int, std::allocator<int>, growth::PageRounded<>> paged(1024, 0);
+    paged.push_back(1);
+    CHECK_EQ(paged.capacity(), 2048);
+    Vector<char, std::allocator<char>, growth::PageRounded<>> bytes(3000, 'a');
+    bytes.push_back('b');
+    CHECK_EQ(bytes.capacity(), 8192);
+
+    CHECK_EQ(growth::SizeClass::size_class(1), 8);
+    CHECK_EQ(growth::SizeClass::size_class(17), 32);
+    CHECK_EQ(growth::SizeClass::size_class(129), 160);
+    CHECK_EQ(growth::SizeClass::size_class(1000), 1024);
+    CHECK_EQ(growth::SizeClass::size_class(1025), 1280);
+    Vector<int, std::allocator<int>, growth::SizeClass> classes{1, 2, 3};
+    classes.push_back(4);
+    CHECK_EQ(classes.capacity(), 4);
+    classes.push_back(5);
+    CHECK_EQ(classes.capacity(), 8);
+    for (int i{0}; i < 100; ++i)
+        classes.push_back(i);
+    CHECK_EQ(classes.size(), 105);
+    CHECK_EQ(classes[104], 99);
+}
+
+TEST_CASE_TEMPLATE("iterators and ranges", V, Vector<int>, SmallVector<int, 4>) {
+    static_assert(std::ranges::contiguous_range<V>);
+    static_assert(std::ranges::contiguous_range<const V>);
+    static_assert(std::ranges::sized_range<V>);
+
+    V v{5, 3, 9, 1, 7, 2};
+    CHECK_EQ(v.end() - v.begin(), 6);
+    CHECK_EQ(v.data(), &v[0]);
+    CHECK_EQ(*v.rbegin(), 2);
+    CHECK_UNARY_FALSE(v.empty());
+    V e{};
+    CHECK_UNARY(e.empty());
+    CHECK_EQ(e.begin(), e.end());
+
+    std::ranges::sort(v);
+    CHECK_UNARY(std::is_sorted(v.begin(), v.end()));
+    CHECK_EQ(v[0], 1);
+    CHECK_EQ(v[5], 9);
+
+    std::span<int> s = v;
+    CHECK_EQ(s.size(), 6);
+    s[0] = 42;
+    CHECK_EQ(v[0], 42);
+
+    const V& c = v;
+    std::span<const int> cs = c;
+    CHECK_EQ(cs.data(), c.data());
+    CHECK_EQ(std::accumulate(c.cbegin(), c.cend(), 0), 42 + 2 + 3 + 5 + 7 + 9);
+
+    int sum{0};
+    for (int x : v | std::views::reverse | std::views::take(2))
+        sum += x;
+    CHECK_EQ(sum, 16);
+}
+
+TEST_CASE("small vector") {
+    static_assert(std::is_same_v<decltype(std::declval<const SmallVector<int, 2>&>().at(0)), const int&>);
+    static_assert(std::is_same_v<decltype(std::declval<const Vector<int>&>().at(0)), const int&>);
+    static_assert(std::is_same_v<decltype(std::declval<const Vector<int>&>()[0]), const int&>);
+
+    SUBCASE("spills to the heap at N + 1 elements") {
+        SmallVector<std::string, 4> v{};
+        CHECK_UNARY(v.is_inline());
+        CHECK_EQ(v.capacity(), 4);
+        for (int i{0}; i < 4; ++i)
+            v.push_back(std::to_string(i));
+        CHECK_UNARY(v.is_inline());
+        CHECK_EQ(v.capacity(), 4);
+        v.push_back("4");
+        CHECK_UNARY_FALSE(v.is_inline());
+        CHECK_EQ(v.size(), 5);
+        CHECK_EQ(v.capacity(), 8);
+        for (size_t i{0}; i < v.size(); ++i)
+            CHECK_EQ(v[i], std::to_string(i));
+
+        // pushing an element of the vector itself while it spills
+        SmallVector<std::string, 2> w{"a", "b"};
+        w.push_back(w[0]);
+        CHECK_UNARY_FALSE(w.is_inline());
+        CHECK_EQ(w[2], "a");
+    }
+
+    SUBCASE("constructor with default value allocates once") {
+        SmallVector<std::string, 4> small(3, "x");
+        CHECK_UNARY(small.is_inline());
+        CHECK_EQ(small.size(), 3);
+        CHECK_EQ(small.capacity(), 4);
+
+        SmallVector<std::string, 4> large(100, "x");
+        CHECK_UNARY_FALSE(large.is_inline());
+        CHECK_EQ(large.size(), 100);
+        CHECK_EQ(large.capacity(), 100);
+        CHECK_UNARY(std::all_of(large.begin(), large.end(), [](const auto& s) { return s == "x"; }));
+
+        SmallVector<int, 2> list{1, 2, 3};
+        CHECK_EQ(list.capacity(), 3);
+        CHECK_EQ(list[2], 3);
+    }
+
+    SUBCASE("copy and move of inline and heap vectors") {
+        for (size_t count : {size_t{3}, size_t{10}}) {
+            CAPTURE(count);
+            SmallVector<std::string, 4> v{};
+            for (size_t i{0}; i < count; ++i)
+                v.push_back(std::to_string(i));
+
+            SmallVector<std::string, 4> copy{v};
+            CHECK_EQ(copy.size(), count);
+            CHECK_EQ(copy.is_inline(), count <= 4);
+            CHECK_NE(copy.data(), v.data());
+            CHECK_UNARY(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+
+            SmallVector<std::string, 4> assigned{"old"};
+            assigned = v;
+            CHECK_UNARY(std::equal(assigned.begin(), assigned.end(), v.begin(), v.end()));
+            const SmallVector<std::string, 4>& self = assigned;
+            assigned = self;
+            CHECK_EQ(assigned.size(), count);
+
+            // a heap buffer is taken over, inline elements are moved one by one
+            const std::string* heap = v.data();
+            SmallVector<std::string, 4> moved{std::move(v)};
+            CHECK_UNARY(v.empty());
+            CHECK_UNARY(v.is_inline());
+            CHECK_EQ(moved.size(), count);
+            CHECK_EQ(moved.data() == heap, count > 4);
+            CHECK_UNARY(std::equal(moved.begin(), moved.end(), copy.begin(), copy.end()));
+
+            SmallVector<std::string, 4> move_assigned(20, "old");
+            move_assigned = std::move(moved);
+            CHECK_UNARY(moved.empty());
+            CHECK_EQ(move_assigned.is_inline(), count <= 4);
+            CHECK_UNARY(std::equal(move_assigned.begin(), move_assigned.end(), copy.begin(), copy.end()));
+
+            // the moved-from vectors are still usable
+            v.push_back("again");
+            CHECK_EQ(v[0], "again");
+        }
+    }
+
+    SUBCASE("pop_back") {
+        {
+            SmallVector<Counted, 2> v{};
+            for (int i{0}; i < 3; ++i)
+                v.push_back(Counted{});
+            CHECK_EQ(Counted::alive, 3);
+            v.pop_back();
+            CHECK_EQ(Counted::alive, 2);
+            CHECK_EQ(v.size(), 2);
+            v.pop_back();
+            v.pop_back();
+            CHECK_EQ(Counted::alive, 0);
+            CHECK_UNARY(v.empty());
+            REQUIRE_THROWS_AS(v.pop_back(), const std::out_of_range&);
+            v.push_back(Counted{});
+        }
+        CHECK_EQ(Counted::alive, 0);
+    }
+
+    SUBCASE("at checks bounds") {
+        SmallVector<int, 4> v{1, 2, 3};
+        v.at(1) = 5;
+        CHECK_EQ(v.at(1), 5);
+        REQUIRE_THROWS_AS(v.at(3), const std::out_of_range&);
+        const SmallVector<int, 4>& c = v;
+        CHECK_EQ(c.at(2), 3);
+        REQUIRE_THROWS_AS(c.at(3), const std::out_of_range&);
+
+        SmallVector<int, 4> e{};
+        REQUIRE_THROWS_AS(e.at(0), const std::out_of_range&);
+    }
+}
+
+TEST_CASE("concurrent vector") {
+    SUBCASE("single thread") {
+        ConcurrentVector<std::string, 2> v{};
+        CHECK_EQ(v.size(), 0);
+        CHECK_EQ(v.begin(), v.end());
+        for (int i{0}; i < 100; ++i)
+            CHECK_EQ(v.push_back(std::to_string(i)), static_cast<size_t>(i));
+        const std::string* first = &v[0];
+        v.emplace_back(3, 'x');
+        CHECK_EQ(v.size(), 101);
+        CHECK_EQ(&v[0], first);
+        CHECK_EQ(v[63], "63");
+        CHECK_EQ(v.at(100), "xxx");
+        REQUIRE_THROWS_AS(v.at(101), const std::out_of_range&);
+
+        size_t count{0};
+        for (const std::string& s : v) {
+            CHECK_EQ(&s, &v[count]);
+            ++count;
+        }
+        CHECK_EQ(count, 101);
+    }
+
+    SUBCASE("a failed construction is never published") {
+        struct Throwing {
+            explicit Throwing(int v) : value{v} {
+                if (v < 0)
+                    throw std::runtime_error("negative");
+            }
+            int value;
+        };
+        ConcurrentVector<Throwing, 4> v{};
+        for (int i{0}; i < 10; ++i)
+            v.emplace_back(i);
+        CHECK_EQ(v.size(), 10);
+        REQUIRE_THROWS_AS(v.emplace_back(-1), const std::runtime_error&);
+        CHECK_EQ(v.reserved(), 11);
+        for (int i{11}; i < 100; ++i)
+            v.emplace_back(i);
+        CHECK_EQ(v.size(), 10);
+        CHECK_EQ(v[9].value, 9);
+        CHECK_EQ(v[50].value, 50);
+        REQUIRE_THROWS_AS(v.at(10), const std::out_of_range&);
+    }
+
+    SUBCASE("many producers") {
+        constexpr size_t threads{8};
+        constexpr size_t per_thread{10000};
+        ConcurrentVector<size_t> v{};
+        {
+            std::vector<std::jthread> producers;
+            for (size_t t{0}; t < threads; ++t)
+                producers.emplace_back([&v, t] {
+                    for (size_t i{0}; i < per_thread; ++i)
+                        v.push_back(t * per_thread + i);
+                });
+            // readers may look at the published prefix while producers append
+            size_t seen{0};
+            while (seen < threads * per_thread) {
+                size_t size = v.size();
+                CHECK_UNARY(size >= seen);
+                seen = size;
+            }
+        }
+        REQUIRE_EQ(v.size(), threads * per_thread);
+        std::vector<size_t> values(v.begin(), v.end());
+        std::ranges::sort(values);
+        for (size_t i{0}; i < values.size(); ++i)
+            REQUIRE_EQ(values[i], i);
+    }
+}
+
+TEST_CASE("printing") {
+    Vector<int> v{};
+    for (int i{0}; i < 10; ++i)
+        v.push_back(i);
+    const Vector<int>& c = v;
+
+    std::ostringstream all;
+    all << c;
+    CHECK_EQ(all.str(), "Size: 10, Capacity: 16\n0, 1, 2, 3, 4, 5, 6, 7, 8, 9\n");
+
+    std::ostringstream some;
+    c.print(some, 2);
+    CHECK_EQ(some.str(), "Size: 10, Capacity: 16\n0, 1, ... (8 more)\n");
+
+    std::ostringstream none;
+    c.print(none, 0);
+    CHECK_EQ(none.str(), "Size: 10, Capacity: 16\n... (10 more)\n");
+
+#if defined(__cpp_lib_format)
+    CHECK_EQ(std::format("{}", c), all.str());
+    CHECK_EQ(std::format("{:2}", c), some.str());
+#endif
 }